@@ -3,114 +3,607 @@
 #include <fstream>
 #include <iostream>
 #include <string>
-#include <sstream>
 #include <algorithm>
-#include <execution>
-#include <unordered_map>
+#include <array>
+#include <map>
 #include <numeric>
+#include <span>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include "utils.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
+#include "ThreadPool.hpp"
+#include "StreamReader.hpp"
+#include "FlatHash.hpp"
 
-std::vector<std::string> argsToString(int argc, char* args[]);
-
+namespace day01 {
 using intVecPair = std::pair<std::vector<int>, std::vector<int>>;
-intVecPair parseListsFromFile(const std::string& fileName);
-uint64_t distancesSum(const intVecPair& inputLists);
-uint64_t similaritiesSum(const intVecPair& inputLists);
+// Second column counts the parser keeps for part 2 go up to this value
+constexpr int MAX_COUNTED_LOCATION = (1 << 20) - 1;
+
+intVecPair parseListsFromFile(const std::string& fileName, std::vector<uint32_t>* secondCounts = nullptr);
+bool parseLocation(const char*& it, const char* end, int& location);
+void sortLocations(std::span<int> locations, std::vector<int>& scratch);
+uint64_t distancesSum(intVecPair& inputLists);
+uint64_t sortedDistancesSum(std::span<const int> first, std::span<const int> second);
+uint64_t similaritiesSum(intVecPair& inputLists);
+uint64_t sortedSimilaritiesSum(std::span<const int> first, std::span<const int> second);
+uint64_t countedSimilaritiesSum(std::span<const int> first, std::span<const int> second, int minValue, int maxValue);
+uint64_t similaritiesFromCounts(std::span<const int> first, std::span<const uint32_t> secondCounts);
+std::pair<uint64_t, uint64_t> streamDistancesAndSimilarities(const std::string& fileName);
+std::pair<uint64_t, uint64_t> incrementalDistancesAndSimilarities(const std::string& fileName);
+
+// Keeps both answers up to date while pairs are appended, without ever
+// sorting. The similarity score only needs per-value counts: a new a meets
+// every b of its value counted so far and the other way around.
+// The distance of the sorted pairing equals the sum over x of
+// |#first <= x - #second <= x| (g(x) below), and a pair (a, b) with a < b
+// adds 1 to g on [a, b), or subtracts 1 on [b, a) when a > b. One insertion
+// re-pairs every larger element, so no tree over ranks keeps the distance in
+// logarithmic time. Instead the values are split into blocks of about
+// sqrt(range) with a lazy offset, the negatives count and a histogram each,
+// which makes adding a pair O(sqrt(range)) and both queries O(1).
+class IncrementalLocations
+{
+public:
+	// Location IDs are five digit numbers
+	static constexpr int DEFAULT_MIN_VALUE = 0;
+	static constexpr int DEFAULT_MAX_VALUE = 99999;
+
+	explicit IncrementalLocations(int minValue = DEFAULT_MIN_VALUE, int maxValue = DEFAULT_MAX_VALUE)
+		: m_minValue{ minValue },
+		m_maxValue{ maxValue },
+		m_firstCounts(valueCount()),
+		m_secondCounts(valueCount()),
+		m_g(valueCount())
+	{
+		m_blockSize = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(valueCount()))));
+		m_blocks.resize((valueCount() + m_blockSize - 1) / m_blockSize);
+		for (size_t i = 0; i < m_blocks.size(); ++i) {
+			m_blocks[i].histogram[0] = blockEnd(i) - blockBegin(i);
+		}
+	}
+
+	void addPair(int first, int second)
+	{
+		if (first < m_minValue || first > m_maxValue || second < m_minValue || second > m_maxValue) {
+			throw std::out_of_range("Location outside the tracked range!");
+		}
+
+		size_t firstIdx = static_cast<size_t>(static_cast<int64_t>(first) - m_minValue);
+		size_t secondIdx = static_cast<size_t>(static_cast<int64_t>(second) - m_minValue);
+		m_similarities += static_cast<uint64_t>(first) * m_secondCounts[firstIdx];
+		++m_firstCounts[firstIdx];
+		m_similarities += static_cast<uint64_t>(second) * m_firstCounts[secondIdx];
+		++m_secondCounts[secondIdx];
+
+		if (firstIdx < secondIdx) {
+			addToRange(firstIdx, secondIdx, 1);
+		}
+		else if (secondIdx < firstIdx) {
+			addToRange(secondIdx, firstIdx, -1);
+		}
+	}
+
+	uint64_t distancesSum() const
+	{
+		return m_distances;
+	}
+
+	uint64_t similaritiesSum() const
+	{
+		return m_similarities;
+	}
+
+private:
+	struct Block
+	{
+		int64_t offset = 0;
+		size_t negatives = 0;
+		// Stored values of g in the block, g is a stored value plus offset
+		aoc::FlatMap<int64_t, size_t> histogram;
+	};
+
+	size_t valueCount() const
+	{
+		return static_cast<size_t>(static_cast<int64_t>(m_maxValue) - m_minValue) + 1;
+	}
+
+	size_t blockBegin(size_t block) const { return block * m_blockSize; }
+	size_t blockEnd(size_t block) const { return std::min(valueCount(), (block + 1) * m_blockSize); }
+
+	// Adds step (1 or -1) to g on [begin, end)
+	void addToRange(size_t begin, size_t end, int step)
+	{
+		size_t firstBlock = begin / m_blockSize;
+		size_t lastBlock = (end - 1) / m_blockSize;
+		if (firstBlock == lastBlock) {
+			addToValues(firstBlock, begin, end, step);
+			return;
+		}
+
+		addToValues(firstBlock, begin, blockEnd(firstBlock), step);
+		for (size_t block = firstBlock + 1; block < lastBlock; ++block) {
+			addToBlock(block, step);
+		}
+		addToValues(lastBlock, blockBegin(lastBlock), end, step);
+	}
+
+	// |g + 1| - |g| is 1 unless g < 0 and |g - 1| - |g| is -1 unless g <= 0
+	void addToBlock(size_t idx, int step)
+	{
+		Block& block = m_blocks[idx];
+		int64_t size = static_cast<int64_t>(blockEnd(idx) - blockBegin(idx));
+		int64_t negatives = static_cast<int64_t>(block.negatives);
+		if (step > 0) {
+			m_distances += size - 2 * negatives;
+			block.negatives -= countOf(block, -1);
+		}
+		else {
+			int64_t nonPositives = negatives + static_cast<int64_t>(countOf(block, 0));
+			m_distances += 2 * nonPositives - size;
+			block.negatives = static_cast<size_t>(nonPositives);
+		}
+		block.offset += step;
+	}
+
+	void addToValues(size_t idx, size_t begin, size_t end, int step)
+	{
+		Block& block = m_blocks[idx];
+		for (size_t i = begin; i < end; ++i) {
+			int64_t before = m_g[i] + block.offset;
+			int64_t after = before + step;
+			m_distances += std::abs(after) - std::abs(before);
+			block.negatives += (after < 0) - (before < 0);
+			--block.histogram[m_g[i]];
+			m_g[i] += step;
+			++block.histogram[m_g[i]];
+		}
+	}
+
+	// Number of places in the block where g is value
+	size_t countOf(const Block& block, int64_t value) const
+	{
+		auto it = block.histogram.find(value - block.offset);
+		return it != block.histogram.end() ? it->second : 0;
+	}
+
+	int m_minValue;
+	int m_maxValue;
+	std::vector<uint64_t> m_firstCounts;
+	std::vector<uint64_t> m_secondCounts;
+	// Stored values of g, without the offset of their block
+	std::vector<int64_t> m_g;
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	uint64_t m_distances = 0;
+	uint64_t m_similarities = 0;
+};
+
+class Day01Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		m_lists = parseListsFromFile(files.at(0), &m_secondCounts);
+	}
+
+	// Sorting only reorders the lists, which neither part depends on.
+	// Part 2 uses the counts from parsing, or the lists part 1 left sorted.
+	std::string part1() override
+	{
+		return std::to_string(distancesSum(m_lists));
+	}
 
+	std::string part2() override
+	{
+		if (!m_secondCounts.empty()) {
+			return std::to_string(similaritiesFromCounts(m_lists.first, m_secondCounts));
+		}
+		return std::to_string(similaritiesSum(m_lists));
+	}
+
+private:
+	intVecPair m_lists;
+	std::vector<uint32_t> m_secondCounts;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day01Solver>();
+}
+}
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
-	std::vector<std::string> runtimeArguments(argsToString(argc - 1, args + 1));
+	using namespace day01;
+
+	std::vector<std::string> runtimeArguments(aoc::argsToString(argc - 1, args + 1));
+	try {
+		aoc::consumeThreadsOption(runtimeArguments);
+		aoc::expandManifests(runtimeArguments);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runtimeArguments, "--stream");
+	bool incremental = aoc::consumeFlag(runtimeArguments, "--incremental");
 	
 	if (runtimeArguments.empty()) {
 		std::cout << "No runtime arguments!";
 		return -1;
 	}
 
-	for (const std::string& argument : runtimeArguments) {
-		 intVecPair parsedPair{ parseListsFromFile(argument) };
-		 uint64_t result = distancesSum(parsedPair);
-		 std::cout << "Distances from file " << argument 
-				   << ": " << result << std::endl;
-
-		 uint64_t simmilaritiesResult = similaritiesSum(parsedPair);
-		 std::cout << "Similarities from file " << argument 
-				   << ": " << simmilaritiesResult << std::endl;
-	}
+	aoc::runBatch(runtimeArguments, [&](const std::string& argument, std::ostream& out) {
+		if (streaming) {
+			auto [distances, similarities] = aoc::profile("stream", [&] { return streamDistancesAndSimilarities(argument); });
+			out << "Distances from file " << argument << ": " << distances << '\n'
+				<< "Similarities from file " << argument << ": " << similarities << '\n';
+			return;
+		}
 
-	return 0;
-}
+		if (incremental) {
+			auto [distances, similarities] = aoc::profile("incremental", [&] { return incrementalDistancesAndSimilarities(argument); });
+			out << "Distances from file " << argument << ": " << distances << '\n'
+				<< "Similarities from file " << argument << ": " << similarities << '\n';
+			return;
+		}
 
+		 std::vector<uint32_t> secondCounts;
+		 intVecPair parsedPair{ aoc::profile("parse", [&] { return parseListsFromFile(argument, &secondCounts); }) };
+		 uint64_t result = aoc::profile("part1", [&] { return distancesSum(parsedPair); });
+		 out << "Distances from file " << argument 
+				   << ": " << result << '\n';
 
+		 uint64_t simmilaritiesResult = aoc::profile("part2", [&] {
+			 return secondCounts.empty() ? similaritiesSum(parsedPair) : similaritiesFromCounts(parsedPair.first, secondCounts);
+		 });
+		 out << "Similarities from file " << argument 
+				   << ": " << simmilaritiesResult << '\n';
+	});
 
-std::vector<std::string> argsToString(int argc, char* args[]) 
-{
-	std::vector<std::string> parsedArgs(argc);
-	for (int i = 0; i < argc; i++) {
-		parsedArgs[i] = args[i];
-	}
-	return parsedArgs;
+	return 0;
 }
+#endif
 
 
-std::pair<std::vector<int>, std::vector<int>> parseListsFromFile(const std::string& fileName)
+namespace day01 {
+// One pass over the mapped file, both numbers of a line go straight into the
+// columns, which are reserved for the line count the first line suggests.
+// Anything after the second number of a line is ignored. With secondCounts
+// the second column is also counted by value, for similaritiesFromCounts;
+// it's left empty when a value falls outside [0, MAX_COUNTED_LOCATION].
+std::pair<std::vector<int>, std::vector<int>> parseListsFromFile(const std::string& fileName, std::vector<uint32_t>* secondCounts)
 {
-	std::ifstream file(fileName);
-	if (!file) {
-		throw std::runtime_error("Cannot open input file!");
-	}
+	aoc::MappedInput file(fileName);
+	const char* it = file.content().data();
+	const char* end = it + file.size();
 
+	size_t firstLineLength = static_cast<size_t>(std::find(it, end, '\n') - it) + 1;
+	size_t estimatedLines = file.size() / firstLineLength + 1;
 	std::vector<int> firstList;
 	std::vector<int> secondList;
-	std::string line;
-	while (std::getline(file, line)) {
+	firstList.reserve(estimatedLines + estimatedLines / 8);
+	secondList.reserve(estimatedLines + estimatedLines / 8);
+
+	bool counting = secondCounts != nullptr;
+	if (counting) {
+		secondCounts->clear();
+	}
+
+	while (it != end) {
 		int firstElement;
 		int secondElement;
-		std::istringstream ss(line);
-		ss >> firstElement >> secondElement;
-
-		if (ss.fail()) {
+		if (!parseLocation(it, end, firstElement) || !parseLocation(it, end, secondElement)) {
 			throw std::runtime_error("File: " + fileName + " is ill-formed!");
 		}
+		while (it != end && *it++ != '\n') {}
 
 		firstList.push_back(firstElement);
 		secondList.push_back(secondElement);
+
+		if (counting) {
+			// Negative values wrap around and fail the same check
+			size_t value = static_cast<size_t>(static_cast<unsigned>(secondElement));
+			if (value >= secondCounts->size()) {
+				if (value > MAX_COUNTED_LOCATION) {
+					secondCounts->clear();
+					counting = false;
+					continue;
+				}
+				secondCounts->resize(std::max(value + 1, secondCounts->size() * 2));
+			}
+			++(*secondCounts)[value];
+		}
+	}
+
+	return { std::move(firstList), std::move(secondList) };
+}
+
+
+// Skips blanks and reads an int, it stays where it was if there's none.
+// Location IDs are short, a plain digit loop beats anything fancier.
+bool parseLocation(const char*& it, const char* end, int& location)
+{
+	const char* pos = it;
+	while (pos != end && (*pos == ' ' || *pos == '\t')) {
+		++pos;
+	}
+	bool negative = pos != end && *pos == '-';
+	pos += negative;
+
+	const char* digitsBegin = pos;
+	uint64_t magnitude = 0;
+	for (unsigned digit; pos != end && (digit = static_cast<unsigned char>(*pos) - '0') < 10; ++pos) {
+		magnitude = magnitude * 10 + digit;
+	}
+
+	// 18 digits can't overflow the accumulator
+	size_t digits = static_cast<size_t>(pos - digitsBegin);
+	uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int>::max()) + negative;
+	if (digits == 0 || digits > 18 || magnitude > limit) {
+		return false;
 	}
 
-	return { firstList, secondList };
+	location = static_cast<int>(negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude));
+	it = pos;
+	return true;
 }
 
 
-uint64_t distancesSum(const intVecPair& inputLists) 
+// Sorts locations in place. When the range of values is no larger than their
+// count they are rewritten from a histogram of it, otherwise an LSD radix sort
+// with 11 bit digits passes them through scratch, only over the digits the
+// range has. Scratch grows as needed and can be reused between calls.
+void sortLocations(std::span<int> locations, std::vector<int>& scratch)
 {
-	std::vector<int> firstVec = inputLists.first;
-	std::vector<int> secondVec = inputLists.second;
+	if (locations.size() < 2) {
+		return;
+	}
+
+	auto [minIt, maxIt] = std::minmax_element(locations.begin(), locations.end());
+	const int64_t minValue = *minIt;
+	const uint32_t range = static_cast<uint32_t>(*maxIt - minValue);
+	auto key = [minValue](int location) { return static_cast<uint32_t>(location - minValue); };
+
+	if (range < locations.size()) {
+		std::vector<size_t> counts(size_t{ range } + 1);
+		for (int location : locations) {
+			++counts[key(location)];
+		}
 
-	if (firstVec.size() != secondVec.size()) {
+		auto out = locations.begin();
+		for (size_t k = 0; k < counts.size(); ++k) {
+			out = std::fill_n(out, counts[k], static_cast<int>(minValue + k));
+		}
+		return;
+	}
+
+	static constexpr unsigned digitBits = 11;
+	static constexpr size_t radix = size_t{ 1 } << digitBits;
+	scratch.resize(locations.size());
+	std::span<int> from = locations;
+	std::span<int> to = scratch;
+	for (unsigned shift = 0; shift < (unsigned)std::bit_width(range); shift += digitBits) {
+		std::array<size_t, radix> offsets{};
+		for (int location : from) {
+			++offsets[(key(location) >> shift) & (radix - 1)];
+		}
+		std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), size_t{});
+
+		for (int location : from) {
+			to[offsets[(key(location) >> shift) & (radix - 1)]++] = location;
+		}
+		std::swap(from, to);
+	}
+
+	if (from.data() != locations.data()) {
+		std::copy(from.begin(), from.end(), locations.begin());
+	}
+}
+
+
+// Sorts both lists in place, the caller's buffers are the only copies
+uint64_t distancesSum(intVecPair& inputLists) 
+{
+	if (inputLists.first.size() != inputLists.second.size()) {
 		throw std::invalid_argument("Input lists have different sizes!");
 	}
 
-	std::sort(std::execution::par, firstVec.begin(), firstVec.end(), std::less{});
-	std::sort(std::execution::par, secondVec.begin(), secondVec.end(), std::less{});
+	// The lists don't depend on each other, so they are sorted at the same time
+	std::array<std::vector<int>*, 2> vecs{ &inputLists.first, &inputLists.second };
+	aoc::parallelFor(0, vecs.size(), 1, [&vecs](size_t begin, size_t end) {
+		std::vector<int> scratch;
+		for (size_t i = begin; i < end; ++i) {
+			sortLocations(*vecs[i], scratch);
+		}
+	});
+
+	return sortedDistancesSum(inputLists.first, inputLists.second);
+}
+
 
+// A plain loop over widened differences, which the compiler vectorizes
+uint64_t sortedDistancesSum(std::span<const int> first, std::span<const int> second)
+{
 	uint64_t sum = 0;
-	size_t n = firstVec.size();
-	for (int i = 0; i < n; ++i) {
-		sum += std::abs(firstVec[i] - secondVec[i]);
+	for (size_t i = 0; i < first.size(); ++i) {
+		int64_t difference = static_cast<int64_t>(first[i]) - second[i];
+		sum += static_cast<uint64_t>(difference < 0 ? -difference : difference);
 	}
 	
 	return sum;
 }
 
 
-uint64_t similaritiesSum(const intVecPair& inputLists)
+// Lists left sorted by distancesSum are merged in one pass. Unsorted lists
+// are counted into a dense array when their range isn't much larger than
+// they are, anything else is sorted in place first like distancesSum does.
+uint64_t similaritiesSum(intVecPair& inputLists)
+{
+	std::vector<int>& first = inputLists.first;
+	std::vector<int>& second = inputLists.second;
+	if (first.empty() || second.empty()) {
+		return 0;
+	}
+
+	if (std::is_sorted(first.begin(), first.end()) && std::is_sorted(second.begin(), second.end())) {
+		return sortedSimilaritiesSum(first, second);
+	}
+
+	static constexpr size_t maxCountsPerElement = 4;
+	auto [minIt, maxIt] = std::minmax_element(second.begin(), second.end());
+	uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(*maxIt) - *minIt);
+	if (range < maxCountsPerElement * (first.size() + second.size())) {
+		return countedSimilaritiesSum(first, second, *minIt, *maxIt);
+	}
+
+	std::vector<int> scratch;
+	sortLocations(first, scratch);
+	sortLocations(second, scratch);
+	return sortedSimilaritiesSum(first, second);
+}
+
+
+// Both lists sorted, equal values are runs met at the same time
+uint64_t sortedSimilaritiesSum(std::span<const int> first, std::span<const int> second)
+{
+	uint64_t sum = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < first.size() && j < second.size()) {
+		if (first[i] < second[j]) {
+			++i;
+		}
+		else if (second[j] < first[i]) {
+			++j;
+		}
+		else {
+			int value = first[i];
+			uint64_t firstCount = 0;
+			uint64_t secondCount = 0;
+			for (; i < first.size() && first[i] == value; ++i) {
+				++firstCount;
+			}
+			for (; j < second.size() && second[j] == value; ++j) {
+				++secondCount;
+			}
+			sum += static_cast<uint64_t>(value) * firstCount * secondCount;
+		}
+	}
+
+	return sum;
+}
+
+
+// Counts of the second list indexed by value - minValue, its smallest value
+uint64_t countedSimilaritiesSum(std::span<const int> first, std::span<const int> second, int minValue, int maxValue)
+{
+	std::vector<uint64_t> counts(static_cast<size_t>(static_cast<int64_t>(maxValue) - minValue) + 1);
+	for (int element : second) {
+		++counts[static_cast<size_t>(static_cast<int64_t>(element) - minValue)];
+	}
+
+	uint64_t sum = 0;
+	for (int element : first) {
+		if (element >= minValue && element <= maxValue) {
+			sum += static_cast<uint64_t>(element) * counts[static_cast<size_t>(static_cast<int64_t>(element) - minValue)];
+		}
+	}
+
+	return sum;
+}
+
+
+// Second list counts indexed by value, as the parser builds them
+uint64_t similaritiesFromCounts(std::span<const int> first, std::span<const uint32_t> secondCounts)
 {
-	std::unordered_map<int, uint64_t> elementCount;
-	for (auto el : inputLists.second) {
-		++elementCount[el];
+	uint64_t sum = 0;
+	for (int element : first) {
+		size_t value = static_cast<size_t>(static_cast<unsigned>(element));
+		if (value < secondCounts.size()) {
+			sum += static_cast<uint64_t>(value) * secondCounts[value];
+		}
 	}
 
-	return std::accumulate(inputLists.first.begin(), inputLists.first.end(), 0ull,
-		[&elementCount](uint64_t sum, int el) {
-			return elementCount.contains(el) ? sum + el * elementCount[el] : sum;
+	return sum;
+}
+
+
+// Only counts of every value are kept, so memory depends on the range of
+// values, not on the length of the file. Counts are in order, which makes
+// walking both of them side by side the same as pairing sorted lists.
+std::pair<uint64_t, uint64_t> streamDistancesAndSimilarities(const std::string& fileName)
+{
+	std::map<int, uint64_t> firstCounts;
+	std::map<int, uint64_t> secondCounts;
+	aoc::StreamReader reader(fileName);
+	reader.forEachLine([&](std::string_view line) {
+		int firstElement;
+		int secondElement;
+		aoc::Scanner scanner{ line };
+		if (!scanner.tryNextInt(firstElement) || !scanner.tryNextInt(secondElement)) {
+			throw std::runtime_error("File: " + fileName + " is ill-formed!");
 		}
-	);
+
+		++firstCounts[firstElement];
+		++secondCounts[secondElement];
+	});
+
+	uint64_t distances = 0;
+	auto firstIt = firstCounts.begin();
+	auto secondIt = secondCounts.begin();
+	uint64_t firstLeft = firstIt != firstCounts.end() ? firstIt->second : 0;
+	uint64_t secondLeft = secondIt != secondCounts.end() ? secondIt->second : 0;
+	while (firstIt != firstCounts.end() && secondIt != secondCounts.end()) {
+		uint64_t paired = std::min(firstLeft, secondLeft);
+		int64_t difference = static_cast<int64_t>(firstIt->first) - secondIt->first;
+		distances += paired * static_cast<uint64_t>(difference < 0 ? -difference : difference);
+		firstLeft -= paired;
+		secondLeft -= paired;
+		if (firstLeft == 0 && ++firstIt != firstCounts.end()) {
+			firstLeft = firstIt->second;
+		}
+		if (secondLeft == 0 && ++secondIt != secondCounts.end()) {
+			secondLeft = secondIt->second;
+		}
+	}
+	if (firstIt != firstCounts.end() || secondIt != secondCounts.end()) {
+		throw std::invalid_argument("Input lists have different sizes!");
+	}
+
+	uint64_t similarities = 0;
+	for (const auto& [element, count] : firstCounts) {
+		auto it = secondCounts.find(element);
+		if (it != secondCounts.end()) {
+			similarities += element * count * it->second;
+		}
+	}
+
+	return { distances, similarities };
+}
+
+
+// Answers are current after every line, as they would be for a file still being written
+std::pair<uint64_t, uint64_t> incrementalDistancesAndSimilarities(const std::string& fileName)
+{
+	IncrementalLocations locations;
+	aoc::StreamReader reader(fileName);
+	reader.forEachLine([&](std::string_view line) {
+		int firstElement;
+		int secondElement;
+		aoc::Scanner scanner{ line };
+		if (!scanner.tryNextInt(firstElement) || !scanner.tryNextInt(secondElement)) {
+			throw std::runtime_error("File: " + fileName + " is ill-formed!");
+		}
+
+		locations.addPair(firstElement, secondElement);
+	});
+
+	return { locations.distancesSum(), locations.similaritiesSum() };
+}
 }
\ No newline at end of file
@@ -2,80 +2,134 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <algorithm>
+#include "utils.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
+#include "StreamReader.hpp"
 
-// utilities
-std::vector<std::string> argsToString(int argc, char* args[]);
+namespace day02 {
 
+// utilities
 template<typename T>
 bool isInRange(T num, T min, T max);
 
+// Rules of the puzzle, the defaults of the runtime options
+constexpr int DEFAULT_MIN_INTERVAL = 1;
+constexpr int DEFAULT_MAX_INTERVAL = 3;
+constexpr int DEFAULT_MAX_REMOVALS = 1;
+
 // should be a class
 using Report = std::vector<int>;
-Report parseReport(const std::string& report);
+Report parseReport(std::string_view report);
 std::vector<Report> parseFileOfReports(const std::string& fileName);
 bool isSafeIncrease(int current, int next, int minInterval, int maxInterval);
 bool isSafeDecrease(int current, int next, int minInterval, int maxInterval);
 bool isReportSafe(const Report& report, int minInterval, int maxInterval);
-bool isReportSafeDamp(const Report& report, int minInterval, int maxInterval);
-uint64_t countSafeReports(const std::vector<Report>& reports);
-uint64_t countSafeReportsDamp(const std::vector<Report>& reports);
+bool isReportSafeDamp(const Report& report, int minInterval, int maxInterval, size_t maxRemovals = DEFAULT_MAX_REMOVALS);
+bool isReportSafeOneRemoved(const Report& report, int minInterval, int maxInterval);
+bool isReportSafeRemoving(const Report& report, int minInterval, int maxInterval, size_t maxRemovals);
+uint64_t countSafeReports(const std::vector<Report>& reports, int minInterval, int maxInterval);
+uint64_t countSafeReportsDamp(const std::vector<Report>& reports, int minInterval, int maxInterval, size_t maxRemovals);
+std::pair<uint64_t, uint64_t> streamSafeReports(const std::string& fileName, int minInterval, int maxInterval, size_t maxRemovals);
+
+class Day02Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		m_reports = parseFileOfReports(files.at(0));
+	}
 
+	std::string part1() override
+	{
+		return std::to_string(countSafeReports(m_reports, DEFAULT_MIN_INTERVAL, DEFAULT_MAX_INTERVAL));
+	}
 
+	std::string part2() override
+	{
+		return std::to_string(countSafeReportsDamp(m_reports, DEFAULT_MIN_INTERVAL, DEFAULT_MAX_INTERVAL, DEFAULT_MAX_REMOVALS));
+	}
 
+private:
+	std::vector<Report> m_reports;
+};
 
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day02Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
-	std::vector<std::string> runtimeArgs{ argsToString(argc - 1, args + 1) };
+	using namespace day02;
+
+	std::vector<std::string> runtimeArgs{ aoc::argsToString(argc - 1, args + 1) };
+	int minInterval = DEFAULT_MIN_INTERVAL;
+	int maxInterval = DEFAULT_MAX_INTERVAL;
+	int maxRemovals = DEFAULT_MAX_REMOVALS;
+	try {
+		aoc::consumeThreadsOption(runtimeArgs);
+		aoc::expandManifests(runtimeArgs);
+		minInterval = aoc::consumeIntOption(runtimeArgs, "--min-interval", DEFAULT_MIN_INTERVAL);
+		maxInterval = aoc::consumeIntOption(runtimeArgs, "--max-interval", DEFAULT_MAX_INTERVAL);
+		maxRemovals = aoc::consumeIntOption(runtimeArgs, "--removals", DEFAULT_MAX_REMOVALS);
+		if (minInterval > maxInterval) {
+			throw std::invalid_argument("--min-interval can't be greater than --max-interval!");
+		}
+		if (maxRemovals < 0) {
+			throw std::invalid_argument("Number of removals can't be negative!");
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runtimeArgs, "--stream");
 
 	if (runtimeArgs.empty()) {
 		std::cout << "No runtime arguments given!";
 		return 1;
 	}
 
-	for (const std::string& argument : runtimeArgs) {
-		try {
-			std::vector<Report> reports{ parseFileOfReports(argument) };
-			std::cout << "Number of safe reports in file "
-				<< argument << ": "
-				<< countSafeReports(reports) << std::endl;
-			std::cout << "Number of safe reports (with dampener) in file "
-				<< argument << ": "
-				<< countSafeReportsDamp(reports) << std::endl;
-		}
-		catch (std::runtime_error& e) {
-			std::cout << e.what();
+	aoc::runBatch(runtimeArgs, [&](const std::string& argument, std::ostream& out) {
+		if (streaming) {
+			auto [safe, safeDamp] = aoc::profile("stream", [&] { return streamSafeReports(argument, minInterval, maxInterval, maxRemovals); });
+			out << "Number of safe reports in file " << argument << ": " << safe << '\n'
+				<< "Number of safe reports (with dampener) in file " << argument << ": " << safeDamp << '\n';
+			return;
 		}
-	}
-
-	return 0;
-}
-
 
+		std::vector<Report> reports{ aoc::profile("parse", [&] { return parseFileOfReports(argument); }) };
+		out << "Number of safe reports in file "
+			<< argument << ": "
+			<< aoc::profile("part1", [&] { return countSafeReports(reports, minInterval, maxInterval); }) << '\n';
+		out << "Number of safe reports (with dampener) in file "
+			<< argument << ": "
+			<< aoc::profile("part2", [&] { return countSafeReportsDamp(reports, minInterval, maxInterval, maxRemovals); }) << '\n';
+	});
 
-std::vector<std::string> argsToString(int argc, char* args[])
-{
-	std::vector<std::string> parsedArgs(argc);
-	for (size_t i = 0; i < argc; i++) {
-		parsedArgs[i] = args[i];
-	}
-	return parsedArgs;
+	return 0;
 }
+#endif
 
 
-
-Report parseReport(const std::string& report)
+namespace day02 {
+Report parseReport(std::string_view report)
 {
 	Report result;
 
 	Report::value_type num;
-	std::istringstream ss(report);
-	while (ss >> num) {
+	aoc::Scanner scanner{ report };
+	while (scanner.tryNextInt(num)) {
 		result.push_back(num);
 	}
 
-	if (ss.fail() && !ss.eof()) {
+	scanner.skipWhitespace();
+	if (!scanner.atEnd()) {
 		throw std::invalid_argument("Uncorrect data in report!");
 	}
 
@@ -87,13 +141,9 @@ Report parseReport(const std::string& report)
 std::vector<Report> parseFileOfReports(const std::string& fileName)
 {
 	std::vector<Report> reports;
-	std::ifstream file(fileName);
-	if (!file) {
-		throw std::runtime_error("Cannot open file: " + fileName);
-	}
+	aoc::MappedInput file(fileName);
 
-	std::string line;
-	while (std::getline(file, line)) {
+	for (std::string_view line : file) {
 		try {
 			reports.emplace_back(parseReport(line));
 		}
@@ -105,6 +155,29 @@ std::vector<Report> parseFileOfReports(const std::string& fileName)
 	return reports;
 }
 
+// Reports are checked as they are read, one at a time
+std::pair<uint64_t, uint64_t> streamSafeReports(const std::string& fileName, int minInterval, int maxInterval, size_t maxRemovals)
+{
+	uint64_t safe = 0;
+	uint64_t safeDamp = 0;
+	aoc::StreamReader reader(fileName);
+	reader.forEachLine([&](std::string_view line) {
+		Report report;
+		try {
+			report = parseReport(line);
+		}
+		catch (std::invalid_argument& e) {
+			std::cerr << e.what() << std::endl;
+			return;
+		}
+
+		safe += isReportSafe(report, minInterval, maxInterval);
+		safeDamp += isReportSafeDamp(report, minInterval, maxInterval, maxRemovals);
+	});
+
+	return { safe, safeDamp };
+}
+
 bool isSafeIncrease(int current, int next, int minInterval, int maxInterval)
 {
 	int diff = next - current;
@@ -117,74 +190,151 @@ bool isSafeDecrease(int current, int next, int minInterval, int maxInterval)
 	return isInRange(diff, minInterval, maxInterval);
 }
 
+// Both directions are followed, like the dampened checks do. With a
+// minInterval of 0 the first two levels can be equal and pick neither.
 bool isReportSafe(const Report& report, int minInterval, int maxInterval)
 {
-	size_t n = report.size();
-	if (n < 2) {
-		return true;
-	}
-
-	bool isIncreasing = report[0] < report[1];
-	auto isSafe = isIncreasing ? isSafeIncrease : isSafeDecrease;
-
-	for (size_t i = 0; i < n - 1; ++i) {
-		if (!isSafe(report[i], report[i + 1], minInterval, maxInterval))
+	bool increasing = true;
+	bool decreasing = true;
+	for (size_t i = 1; i < report.size(); ++i) {
+		increasing = increasing && isSafeIncrease(report[i - 1], report[i], minInterval, maxInterval);
+		decreasing = decreasing && isSafeDecrease(report[i - 1], report[i], minInterval, maxInterval);
+		if (!increasing && !decreasing) {
 			return false;
+		}
 	}
 
 	return true;
 }
 
 
-uint64_t countSafeReports(const std::vector<Report>& reports)
+uint64_t countSafeReports(const std::vector<Report>& reports, int minInterval, int maxInterval)
 {
-	constexpr int minDiff = 1;
-	constexpr int maxDiff = 3;
 	return std::count_if(reports.begin(), reports.end(),
-		[&](const auto& r) { return isReportSafe(r, minDiff, maxDiff); });
+		[&](const auto& r) { return isReportSafe(r, minInterval, maxInterval); });
 }
 
-uint64_t countSafeReportsDamp(const std::vector<Report>& reports)
+uint64_t countSafeReportsDamp(const std::vector<Report>& reports, int minInterval, int maxInterval, size_t maxRemovals)
 {
-	constexpr int minDiff = 1;
-	constexpr int maxDiff = 3;
 	return std::count_if(reports.begin(), reports.end(),
-		[&](const auto& r) { return isReportSafeDamp(r, minDiff, maxDiff); });
+		[&](const auto& r) { return isReportSafeDamp(r, minInterval, maxInterval, maxRemovals); });
 }
 
-bool isReportSafeDamp(const Report& report, int minInterval, int maxInterval)
+// Safe once at most maxRemovals levels are taken out. The puzzle's single
+// removal has a pass of its own, which keeps it free of allocations.
+bool isReportSafeDamp(const Report& report, int minInterval, int maxInterval, size_t maxRemovals)
+{
+	if (maxRemovals == 1) {
+		return isReportSafeOneRemoved(report, minInterval, maxInterval);
+	}
+	return isReportSafeRemoving(report, minInterval, maxInterval, maxRemovals);
+}
+
+// One forward pass checking both directions at once, nothing is copied.
+// For each direction it keeps whether the levels read so far are safe with
+// all of them kept, with the last one kept after an earlier one was removed,
+// or with the last one removed. The level before the last is enough to
+// extend the last of these.
+bool isReportSafeOneRemoved(const Report& report, int minInterval, int maxInterval)
 {
 	size_t n = report.size();
 	if (n <= 2) {
 		return true;
 	}
 
-	bool isIncreasing = report[0] < report[1];
-	auto isSafe = isIncreasing ? isSafeIncrease : isSafeDecrease;
-
-	for (size_t i = 0; i < n - 1; i++) {
-		if (!isSafe(report[i], report[i + 1], minInterval, maxInterval)) {
-			Report withoutCurr{ report };
-			Report withoutNext{ report };
-			withoutCurr.erase(withoutCurr.begin() + i);
-			withoutNext.erase(withoutNext.begin() + i + 1);
-			bool ret =	isReportSafe(withoutCurr, minInterval, maxInterval) ||
-						isReportSafe(withoutNext, minInterval, maxInterval);
-			if (i > 0) {
-				Report withoutPrev{ report };
-				withoutPrev.erase(withoutPrev.begin() + i - 1);
-				ret = ret || isReportSafe(withoutPrev, minInterval, maxInterval);
-			}
-			return ret;
+	struct DampState
+	{
+		bool allKept = true;
+		bool lastKept = false;
+		bool lastRemoved = true;
+
+		bool alive() const { return allKept || lastKept || lastRemoved; }
+
+		void advance(bool safeFromPrev, bool safeFromBeforePrev)
+		{
+			*this = { allKept && safeFromPrev, (lastKept && safeFromPrev) || (lastRemoved && safeFromBeforePrev), allKept };
 		}
+	};
+
+	DampState increasing;
+	DampState decreasing;
+	int beforePrev = 0;
+	int prev = report[0];
+	for (size_t i = 1; i < n; ++i) {
+		int level = report[i];
+		// Removing the first level leaves nothing before this one
+		bool first = i == 1;
+		increasing.advance(isSafeIncrease(prev, level, minInterval, maxInterval),
+			first || isSafeIncrease(beforePrev, level, minInterval, maxInterval));
+		decreasing.advance(isSafeDecrease(prev, level, minInterval, maxInterval),
+			first || isSafeDecrease(beforePrev, level, minInterval, maxInterval));
+		if (!increasing.alive() && !decreasing.alive()) {
+			return false;
+		}
+
+		beforePrev = prev;
+		prev = level;
 	}
 
 	return true;
 }
 
 
+// Longest safe subsequence for both directions: fewest[j] is the fewest
+// removals leaving a safe sequence that ends by keeping level j. Its
+// previous kept level is one of the maxRemovals + 1 before it, any further
+// back removes too many, so only that window of fewest is kept, as a ring.
+// Counts above maxRemovals are all the same, dead. Once a whole window is
+// dead for both directions no later level can be reached and the check
+// stops. O(n * maxRemovals) time and O(maxRemovals) space.
+bool isReportSafeRemoving(const Report& report, int minInterval, int maxInterval, size_t maxRemovals)
+{
+	size_t n = report.size();
+	if (n <= maxRemovals + 1) {
+		return true;
+	}
+
+	const size_t window = maxRemovals + 1;
+	const size_t dead = maxRemovals + 1;
+	std::vector<size_t> fewestIncreasing(window, dead);
+	std::vector<size_t> fewestDecreasing(window, dead);
+	for (size_t j = 0; j < n; ++j) {
+		// Removing every level before j
+		size_t increasing = std::min(j, dead);
+		size_t decreasing = increasing;
+		for (size_t i = j > window ? j - window : 0; i < j; ++i) {
+			size_t removedBetween = j - i - 1;
+			if (isSafeIncrease(report[i], report[j], minInterval, maxInterval)) {
+				increasing = std::min(increasing, fewestIncreasing[i % window] + removedBetween);
+			}
+			if (isSafeDecrease(report[i], report[j], minInterval, maxInterval)) {
+				decreasing = std::min(decreasing, fewestDecreasing[i % window] + removedBetween);
+			}
+		}
+		fewestIncreasing[j % window] = std::min(increasing, dead);
+		fewestDecreasing[j % window] = std::min(decreasing, dead);
+
+		// Removing every level after j
+		size_t removedAfter = n - 1 - j;
+		if (std::min(increasing, decreasing) + removedAfter <= maxRemovals) {
+			return true;
+		}
+
+		bool windowDead = j >= maxRemovals
+			&& std::all_of(fewestIncreasing.begin(), fewestIncreasing.end(), [&](size_t f) { return f >= dead; })
+			&& std::all_of(fewestDecreasing.begin(), fewestDecreasing.end(), [&](size_t f) { return f >= dead; });
+		if (windowDead) {
+			return false;
+		}
+	}
+
+	return false;
+}
+
+
 
 template<typename T>
 bool isInRange(T num, T min, T max) {
 	return num >= min && num <= max;
-}
\ No newline at end of file
+}
+}
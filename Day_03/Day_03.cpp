@@ -3,10 +3,14 @@
 #include <iostream>
 #include <fstream>
 #include <regex>
+#include "utils.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
+
+namespace day03 {
 
 // general utils
 std::string loadTextFile(const std::string& fileName);
-std::vector<std::string> argsToString(int argc, char* args[]);
 std::vector<std::smatch> findAllExpressions(const std::string& line, const std::regex& expression);
 
 // solution
@@ -15,46 +19,79 @@ std::vector<std::string> findMuls(const std::string& fileContent);
 std::vector<std::string> findInstructions(const std::string& code);
 uint64_t sumInstructions(const std::vector<std::string>& instructions);
 
+class Day03Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		m_code = loadTextFile(files.at(0));
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(sumInstructions(findMuls(m_code)));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(sumInstructions(findInstructions(m_code)));
+	}
+
+private:
+	std::string m_code;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day03Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
-	std::vector<std::string> runtimeArgs{ argsToString(argc - 1, args + 1) };
+	using namespace day03;
+
+	std::vector<std::string> runtimeArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runtimeArgs);
+		aoc::expandManifests(runtimeArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	if (runtimeArgs.empty()) {
 		std::cerr << "No file names given!" << std::endl;
 		return 1;
 	}
 
 
-	for (const std::string& arg : runtimeArgs) {
-		try {
-			std::string fileContent{ loadTextFile(arg) };
-			std::cout	<< "Sum of just muls from file: " << arg 
-						<< " " << sumInstructions(findMuls(fileContent)) 
-						<< std::endl;
+	aoc::runBatch(runtimeArgs, [&](const std::string& arg, std::ostream& out) {
+		std::string fileContent{ aoc::profile("load", [&] { return loadTextFile(arg); }) };
+		out	<< "Sum of just muls from file: " << arg 
+					<< " " << aoc::profile("part1", [&] { return sumInstructions(findMuls(fileContent)); }) 
+					<< '\n';
 
-			std::cout	<< "Sum of muls with do's and dont's in file: " << arg
-						<< " " << sumInstructions(findInstructions(fileContent)) 
-						<< std::endl;
-		}
-		catch (std::exception& e) {
-			std::cout << e.what();
-		}
-	}
+		out	<< "Sum of muls with do's and dont's in file: " << arg
+					<< " " << aoc::profile("part2", [&] { return sumInstructions(findInstructions(fileContent)); }) 
+					<< '\n';
+	});
 
 	return 0;
 }
+#endif
 
 
-
+namespace day03 {
 std::string loadTextFile(const std::string& fileName)
 {
-	std::ifstream file(fileName);
-	if (!file) {
-		throw std::runtime_error("Cannot open file: " + fileName);
-	}
+	aoc::MappedInput file(fileName);
 
 	std::string fileContent;
-	for (std::string line; std::getline(file, line);) {
+	fileContent.reserve(file.size());
+	for (std::string_view line : file) {
 		fileContent += line;
 	}
 
@@ -134,13 +171,4 @@ int evalMul(const std::string& mul)
 	int secondNum	= std::stoi(matches[1].str());
 	return firstNum * secondNum;
 }
-
-
-std::vector<std::string> argsToString(int argc, char* args[])
-{
-	std::vector<std::string> parsedArgs(argc);
-	for (size_t i = 0; i < argc; i++) {
-		parsedArgs[i] = args[i];
-	}
-	return parsedArgs;
-}
\ No newline at end of file
+}
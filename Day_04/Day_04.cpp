@@ -2,39 +2,81 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <optional>
 #include "utils.hpp"
 #include "LetterBoard.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
 
-std::vector<std::string> loadFile(const std::string& fileName);
+namespace day04 {
 
 uint64_t countXmasAppearance(const LetterBoard& board);
 uint64_t countCrossMasAppeareance(const LetterBoard& board);
 
+class Day04Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_board.emplace(input.lines());
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(countXmasAppearance(m_board.value()));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(countCrossMasAppeareance(m_board.value()));
+	}
+
+private:
+	std::optional<LetterBoard> m_board;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day04Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day04;
+
 	std::vector<std::string> runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	
 	if (runArgs.empty()) {
 		std::cerr << "No files to check!" << std::endl;
 		return 1;
 	}
 
-	for (const std::string& arg : runArgs) {
-		try {
-			LetterBoard board{ loadFile(arg) };
-			std::cout << "Num of XMAS for file: " << arg
-				<< " " << countXmasAppearance(board) << std::endl;
-			std::cout << "Num of X-MAS for file: " << arg
-				<< " " << countCrossMasAppeareance(board) << std::endl;
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		LetterBoard board = aoc::profile("parse", [&] { return LetterBoard{ input.lines() }; });
+		out << "Num of XMAS for file: " << arg
+			<< " " << aoc::profile("part1", [&] { return countXmasAppearance(board); }) << '\n';
+		out << "Num of X-MAS for file: " << arg
+			<< " " << aoc::profile("part2", [&] { return countCrossMasAppeareance(board); }) << '\n';
+	});
 	return 0;
 }
+#endif
 
 
+namespace day04 {
 uint64_t countXmasAppearance(const LetterBoard& board)
 {
 	uint64_t cnt{};
@@ -58,22 +100,4 @@ uint64_t countCrossMasAppeareance(const LetterBoard& board)
 	}
 	return cnt;
 }
-
-
-std::vector<std::string> loadFile(const std::string& fileName)
-{
-	std::ifstream file(fileName);
-
-	if (!file) {
-		throw std::runtime_error("Can't open file: " + fileName);
-	}
-
-	std::vector<std::string> fileContent;
-	while(!file.eof()) {
-		std::string line;
-		std::getline(file, line);
-		fileContent.emplace_back(line);
-	}
-
-	return fileContent;
-}
\ No newline at end of file
+}
@@ -1,27 +1,22 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
+#include "Grid.hpp"
 
+namespace day04 {
 class LetterBoard {
 public:
-	LetterBoard(const std::vector<std::string>& board)
-		: m_board{ board }
-	{
-		if (!isRectangular())
-			throw std::runtime_error("Non rectangle board");
-	};
-
-	LetterBoard(std::vector<std::string>&& board)
-		: m_board{ std::move(board) }
-	{
-		if (!isRectangular())
-			throw std::runtime_error("Non rectangle board");
-	};
+	// Border is wide enough that no searched word can walk out of the grid
+	LetterBoard(const std::vector<std::string_view>& board, size_t maxWordLength = 4)
+		: m_maxWordLength{ maxWordLength },
+		m_board{ aoc::Grid<char>::fromLines(board, [](char c) { return c; }, maxWordLength - 1, m_outsideChar) }
+	{};
 
 	char get(size_t x, size_t y) const
 	{
-		return m_board[y][x];
+		return m_board.at({ (int64_t)x, (int64_t)y });
 	}
 
 	bool contains(size_t x, size_t y) const
@@ -31,29 +26,22 @@ public:
 
 	size_t sizeX() const
 	{
-		return m_board[0].size();
+		return m_board.sizeX();
 	}
 
 	size_t sizeY() const
 	{
-		return m_board.size();
+		return m_board.sizeY();
 	}
 
-	int countWordAppearance(const std::string& word, int x, int y) const;
+	int countWordAppearance(std::string_view word, int x, int y) const;
 	bool isCrossMas(int x, int y) const;
 
 private:
-	enum Dir {
-		UP,
-		UP_RIGHT,
-		RIGHT,
-		DOWN_RIGHT,
-		DOWN,
-		DOWN_LEFT,
-		LEFT,
-		UP_LEFT
-	};
-	bool lookForWord(const std::string& word, int x, int y, Dir dir) const;
-	bool isRectangular();
-	std::vector<std::string> m_board;
-};
\ No newline at end of file
+	bool lookForWord(std::string_view word, aoc::Grid<char>::Index idx, aoc::Grid<char>::Offset step) const;
+
+	static constexpr char m_outsideChar = '\0';
+	size_t m_maxWordLength;
+	aoc::Grid<char> m_board;
+};
+}
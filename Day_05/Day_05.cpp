@@ -1,41 +1,96 @@
 ﻿#include <iostream>
 #include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
 #include "PageRules.hpp"
 #include "Pages.hpp"
 
+namespace day05 {
+
 uint64_t sumCorrectMidPages(const std::vector<Pages>& pagesVec, const PageRules& rules);
 uint64_t sumOfFixedMids(std::vector<Pages> pagesVec, const PageRules& rules);
 
-int main(int argc, char* args[])
+class Day05Solver : public aoc::Solver
 {
-	std::vector<std::string> runArgs = aoc::argsToString(argc - 1, args + 1);
+public:
+	// Rules file first, then the file with page updates
+	void parse(const std::vector<std::string>& files) override
+	{
+		if (files.size() != 2) {
+			throw std::invalid_argument("Day 5 needs rules and pages files");
+		}
 
-	if (runArgs.size() != 2) {
-		std::cerr << "Number of given files isn't equal to two" << std::endl;
-		return 1;
+		m_rules = PageRules::loadFromFile(files[0]);
+		m_pagesVec = Pages::loadFromFile(files[1]);
 	}
 
-	try {
-		const std::string& rulesFileName = runArgs[0];
-		const std::string& pagesFileName = runArgs[1];
+	std::string part1() override
+	{
+		return std::to_string(sumCorrectMidPages(m_pagesVec, m_rules));
+	}
 
-		auto rules = PageRules::loadFromFile(rulesFileName);
-		auto pagesVec = Pages::loadFromFile(pagesFileName);
+	std::string part2() override
+	{
+		return std::to_string(sumOfFixedMids(m_pagesVec, m_rules));
+	}
 
-		std::cout << "Sum of pages mids: " 
-			<< sumCorrectMidPages(pagesVec, rules) << std::endl;
+private:
+	PageRules m_rules;
+	std::vector<Pages> m_pagesVec;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day05Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
+int main(int argc, char* args[])
+{
+	using namespace day05;
 
-		std::cout << "Sum of fixed pages mids: " 
-			<< sumOfFixedMids(pagesVec, rules) << std::endl;
+	std::vector<std::string> runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
 	}
 	catch (std::exception& e) {
 		std::cerr << e.what() << std::endl;
+		return 1;
 	}
 
+	if (runArgs.empty() || runArgs.size() % 2 != 0) {
+		std::cerr << "Files must be given in pairs of rules and pages" << std::endl;
+		return 1;
+	}
+
+	// Every run takes a rules file followed by its pages file
+	std::vector<std::pair<std::string, std::string>> fileSets;
+	for (size_t i = 0; i < runArgs.size(); i += 2) {
+		fileSets.emplace_back(runArgs[i], runArgs[i + 1]);
+	}
+
+	aoc::runBatch(fileSets, [](const std::pair<std::string, std::string>& files, std::ostream& out) {
+		const auto& [rulesFileName, pagesFileName] = files;
+
+		auto rules = aoc::profile("parse/rules", [&] { return PageRules::loadFromFile(rulesFileName); });
+		auto pagesVec = aoc::profile("parse/pages", [&] { return Pages::loadFromFile(pagesFileName); });
+
+		out << "Sum of pages mids: " 
+			<< aoc::profile("part1", [&] { return sumCorrectMidPages(pagesVec, rules); }) << '\n';
+
+		out << "Sum of fixed pages mids: " 
+			<< aoc::profile("part2", [&] { return sumOfFixedMids(pagesVec, rules); }) << '\n';
+	});
+
 	return 0;
 }
+#endif
 
 
+namespace day05 {
 uint64_t sumCorrectMidPages(const std::vector<Pages>& pagesVec, const PageRules& rules)
 {
 	uint64_t sum{};
@@ -57,4 +112,5 @@ uint64_t sumOfFixedMids(std::vector<Pages> pagesVec, const PageRules& rules)
 	}
 
 	return sum;
-}
\ No newline at end of file
+}
+}
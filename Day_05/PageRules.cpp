@@ -1,17 +1,16 @@
 #include "PageRules.hpp"
-#include <sstream>
 #include "utils.hpp"
 
+namespace day05 {
 PageRules PageRules::loadFromFile(const std::string& fileName)
 {
-	std::vector<std::string> lines{ aoc::loadFile(fileName) };
+	aoc::MappedInput input(fileName);
 
 	PageRules rules;
-	for (const std::string& line : lines) {
-		std::stringstream ss(line);
-		char separator;
+	for (std::string_view line : input) {
+		aoc::Scanner scanner{ line };
 		int mustBePrintedBefore, mustBePrintedAfter;
-		if (ss >> mustBePrintedBefore >> separator >> mustBePrintedAfter) {
+		if (scanner.tryNextInt(mustBePrintedBefore) && scanner.skip('|') && scanner.tryNextInt(mustBePrintedAfter)) {
 			rules.addRule(mustBePrintedAfter, mustBePrintedBefore);
 		}
 		else {
@@ -36,4 +35,5 @@ const std::unordered_set<int>& PageRules::getConstraintsFor(int pageNum) const
 void PageRules::addRule(int ruleFor, int mustBeBefore)
 {
 	m_rules[ruleFor].insert(mustBeBefore);
-}
\ No newline at end of file
+}
+}
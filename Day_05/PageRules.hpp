@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include <string>
 
+namespace day05 {
 class PageRules
 {
 public:
@@ -15,4 +16,4 @@ private:
 	std::unordered_map<int, std::unordered_set<int>> m_rules;
 	std::unordered_set<int> m_emptySet;
 };
-
+}
@@ -1,26 +1,25 @@
 #include "Pages.hpp"
 #include "utils.hpp"
-#include <sstream>
 
+namespace day05 {
 std::vector<Pages> Pages::loadFromFile(const std::string& fileName)
 {
-	std::vector<std::string> lines{ aoc::loadFile(fileName) };
+	aoc::MappedInput input(fileName);
 	std::vector<Pages> pagesVec;
 
-	for (std::string& line : lines) {
-		if (line.back() != ',') {
-			line.push_back(',');
-		}
-
-		std::stringstream ss(line);
+	for (std::string_view line : input) {
+		aoc::Scanner scanner{ line };
 		Pages pages;
 		int pageNum;
-		char separator;
-		while (ss >> pageNum >> separator) {
+		while (scanner.tryNextInt(pageNum)) {
 			pages.push_back(pageNum);
+			if (!scanner.skip(',')) {
+				break;
+			}
 		}
 
-		if (ss.bad()) {
+		scanner.skipWhitespace();
+		if (!scanner.atEnd()) {
 			throw std::runtime_error("Pages file " + fileName + " is damaged");
 		}
 
@@ -81,4 +80,5 @@ int Pages::firstReplacementIdx(int numIdx, const PageRules& rules) const
 void Pages::swapPages(int firstIdx, int secondIdx)
 {
 	std::swap(at(firstIdx), at(secondIdx));
-}
\ No newline at end of file
+}
+}
@@ -2,6 +2,7 @@
 #include <vector>
 #include "PageRules.hpp"
 
+namespace day05 {
 class Pages : public std::vector<int>
 {
 public:
@@ -16,4 +17,5 @@ private:
 	int firstBadElementIdx(const PageRules& rules) const;
 	int firstReplacementIdx(int numIdx, const PageRules& rules) const;
 	void swapPages(int firstIdx, int secondIdx);
-};
\ No newline at end of file
+};
+}
@@ -1,35 +1,17 @@
 ﻿#include <iostream>
 #include <vector>
 #include <string>
-#include <unordered_set>
+#include <array>
+#include <optional>
 #include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <Grid.hpp>
+#include <FlatHash.hpp>
+#include <BitGrid.hpp>
+#include <ThreadPool.hpp>
 
-
-struct Vec2D 
-{
-	int x, y;
-};
-
-
-struct Point 
-{
-	int x, y;
-
-	bool operator==(const Point& p) const { return x == p.x && y == p.y; }
-	Point operator+(Vec2D v) const { return{ x + v.x, y + v.y }; }
-	Point operator-(Vec2D v) const { return {x - v.x, y - v.y}; }
-	Point& operator+=(Vec2D v) { return *this = *this + v; }
-};
-
-template<>
-struct std::hash<Point>
-{
-	size_t operator()(const Point& p) const noexcept
-	{
-		return std::hash<int>{}(p.x) ^ std::hash<int>{}(p.y) << 1;
-	}
-};
-
+namespace day06 {
 
 class Guard 
 {
@@ -40,72 +22,53 @@ public:
 		DOWN = 2,
 		LEFT = 3
 	};
+	using Index = aoc::Grid<char>::Index;
+	using DirOffsets = std::array<aoc::Grid<char>::Offset, 4>;
 
-	Guard(Point pos = {}, Dir dir = Dir::UP) : m_pos{pos}, m_dir{dir} {};
-	Point getPosition() const { return m_pos; }
-	Point getNextStep() const { return  m_pos + getDirVector(); }
+	// dirOffsets are linear offsets on the board, in order of Dir
+	Guard(Index pos, const DirOffsets& dirOffsets, Dir dir = Dir::UP) 
+		: m_pos{pos}, m_dirOffsets{dirOffsets}, m_dir{dir} {};
+	Index getPosition() const { return m_pos; }
+	Index getNextStep() const { return m_pos + m_dirOffsets[(int)m_dir]; }
 
-	void moveTo(Point position) { m_pos = position; };
+	void moveTo(Index position) { m_pos = position; };
 	void turnRight() { m_dir = static_cast<Dir>(((int)m_dir + 1) % 4); }
 	bool facesUp() { return m_dir == Dir::UP; }
 
 private:
-	Vec2D getDirVector() const
-	{
-		switch (m_dir) {
-			using enum Dir;
-			case UP:	return { 0,-1 };
-			case RIGHT: return { 1, 0 };
-			case DOWN:	return { 0, 1 };
-			case LEFT:	return {-1, 0 };
-			default:	return { 0, 0 };
-		}
-	}
-
+	Index m_pos;
+	DirOffsets m_dirOffsets;
 	Dir m_dir = Dir::UP;
-	Point m_pos;
 };
 
 class Board
 {
 public:
-	Board(const std::vector<std::string>& board)
-		:	m_board{ board }, 
+	// board is surrounded by m_outsideChar, stepping on it ends the guard's walk
+	Board(const std::vector<std::string_view>& board)
+		:	m_board{ aoc::Grid<char>::fromLines(board, [](char c) { return c; }, 1, m_outsideChar) },
+			m_dirOffsets{ m_board.offset({0,-1}), m_board.offset({1,0}), m_board.offset({0,1}), m_board.offset({-1,0}) },
 			m_initialGuardPos{ findGuardOnBoard() } 
 	{}
 
-	Board(std::vector<std::string>&& board)
-		:	m_board{ std::move(board) }, 
-			m_initialGuardPos{ findGuardOnBoard() } 
-	{}
-
-	bool contains(const Point& p) const
-	{
-		return p.y >= 0 && p.y < sizeY() && p.x >= 0 && p.x < sizeX(p.y);
-	}
-
-	void addObstacle(const Point& p)
-	{
-		m_board[p.y][p.x] = m_obstacleChar;
-	}
-
-	void removeObstacle(const Point& p)
+	bool contains(const aoc::Position& p) const
 	{
-		m_board[p.y][p.x] = m_defaultChar;
+		return m_board.contains(p);
 	}
 
-	std::unordered_set<Point> getVisitedFields() const
+	aoc::BitGrid getVisitedFields() const
 	{
-		Guard guard(m_initialGuardPos);
-		std::unordered_set<Point> visitedTiles{ m_initialGuardPos };
-		Point nextTile = guard.getNextStep();
-		while (contains(nextTile)) {
+		Guard guard(m_board.index(m_initialGuardPos), m_dirOffsets);
+		aoc::BitGrid visitedTiles(sizeX(), sizeY());
+		visitedTiles.set(m_initialGuardPos);
+		Guard::Index nextTile = guard.getNextStep();
+		while (m_board[nextTile] != m_outsideChar) {
 			if (isObstacle(nextTile)) {
 				guard.turnRight();
 			}
 			else {
 				guard.moveTo(nextTile);
-				visitedTiles.insert(nextTile);
+				visitedTiles.set(m_board.position(nextTile));
 			}
 			nextTile = guard.getNextStep();
 		}
@@ -113,14 +76,18 @@ public:
 		return visitedTiles;
 	}
 
-	bool isGuardPathLooped() const
+	// The board itself isn't modified, so many threads can check different obstacles at once.
+	// visitedUpTiles is only scratch space, passing the same set to every call reuses its memory
+	bool isGuardPathLooped(const aoc::Position& extraObstacle, aoc::FlatSet<Guard::Index>& visitedUpTiles) const
 	{
-		std::unordered_set<Point> visitedUpTiles{m_initialGuardPos};
-		Guard guard(m_initialGuardPos);
-		Point nextStep = guard.getNextStep();
-
-		while (contains(nextStep)) {
-			if (isObstacle(nextStep)) {
+		Guard::Index extraObstacleIdx = m_board.index(extraObstacle);
+		visitedUpTiles.clear();
+		visitedUpTiles.insert(m_board.index(m_initialGuardPos));
+		Guard guard(m_board.index(m_initialGuardPos), m_dirOffsets);
+		Guard::Index nextStep = guard.getNextStep();
+
+		while (m_board[nextStep] != m_outsideChar) {
+			if (isObstacle(nextStep) || nextStep == extraObstacleIdx) {
 				if (guard.facesUp()) {
 					if (visitedUpTiles.contains(nextStep)) {
 						return true;
@@ -139,32 +106,32 @@ public:
 		return false;
 	}
 
-	Point getInitialGuardPosition() const
+	aoc::Position getInitialGuardPosition() const
 	{
 		return m_initialGuardPos;
 	}
 
 	size_t sizeY() const
 	{
-		return m_board.size();
+		return m_board.sizeY();
 	}
 
-	size_t sizeX(size_t row) const
+	size_t sizeX() const
 	{
-		return m_board[row].size();
+		return m_board.sizeX();
 	}
 
 private:
-	bool isObstacle(const Point& p) const
+	bool isObstacle(Guard::Index idx) const
 	{
-		return m_board[p.y][p.x] == m_obstacleChar;
+		return m_board[idx] == m_obstacleChar;
 	}
 
-	Point findGuardOnBoard()
+	aoc::Position findGuardOnBoard()
 	{
-		for (int y = 0; y < sizeY(); y++) {
-			for (int x = 0; x < sizeX(y); x++) {
-				if (m_board[y][x] == m_guardChar)
+		for (int64_t y = 0; y < (int64_t)sizeY(); y++) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); x++) {
+				if (m_board.at({ x,y }) == m_guardChar)
 					return { x,y };
 			}
 		}
@@ -174,54 +141,100 @@ private:
 	static constexpr const char m_guardChar = '^';
 	static constexpr const char m_obstacleChar = '#';
 	static constexpr const char m_defaultChar = '.';
+	static constexpr const char m_outsideChar = ' ';
 
-	std::vector<std::string> m_board;
-	Point m_initialGuardPos;
+	aoc::Grid<char> m_board;
+	Guard::DirOffsets m_dirOffsets;
+	aoc::Position m_initialGuardPos;
 };
 
 uint64_t countVisitedFields(const Board& board)
 {
-	return board.getVisitedFields().size();
+	return board.getVisitedFields().count();
 }
 
-uint64_t countLoopingObstacles(Board& board) 
+uint64_t countLoopingObstacles(const Board& board) 
 {
 	auto visitedFields = board.getVisitedFields();
-	visitedFields.erase(board.getInitialGuardPosition());
+	visitedFields.reset(board.getInitialGuardPosition());
+	std::vector<aoc::Position> candidates;
+	candidates.reserve(visitedFields.count());
+	visitedFields.forEach([&candidates](size_t x, size_t y) {
+		candidates.push_back({ (int64_t)x, (int64_t)y });
+	});
+
+	return aoc::parallelReduce(size_t{}, candidates.size(), 0, uint64_t{},
+		[&board, &candidates](size_t begin, size_t end) {
+			uint64_t cnt{};
+			aoc::FlatSet<Guard::Index> visitedUpTiles;
+			for (size_t i = begin; i < end; ++i) {
+				cnt += board.isGuardPathLooped(candidates[i], visitedUpTiles);
+			}
+			return cnt;
+		},
+		std::plus<uint64_t>());
+}
 
-	uint64_t cnt{};
-	for (const Point& field : visitedFields) {
-		board.addObstacle(field);
-		cnt += board.isGuardPathLooped();
-		board.removeObstacle(field);
+class Day06Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_board.emplace(input.lines());
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(countVisitedFields(m_board.value()));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(countLoopingObstacles(m_board.value()));
 	}
 
-	return cnt;
+private:
+	std::optional<Board> m_board;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day06Solver>();
+}
 }
 
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day06;
+
 	auto runtimeArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runtimeArgs);
+		aoc::expandManifests(runtimeArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	if (runtimeArgs.empty()) {
 		std::cerr << "No given files to analyse!" << std::endl;
 		return 1;
 	}
 
-	for (const std::string& arg : runtimeArgs) {
-		try {
-			Board board{ aoc::loadFile(arg) };
-			std::cout
-				<< "File: " << arg << std::endl
-				<< "Number of visited fields: "
-				<< countVisitedFields(board) << std::endl
-				<< "Number of looping obstacles: "
-				<< countLoopingObstacles(board) << std::endl;
-		}
-		catch (std::exception& e) {
-			std::cout << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runtimeArgs, [&](const std::string& arg, std::ostream& out) {
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		Board board = aoc::profile("parse", [&] { return Board{ input.lines() }; });
+		out
+			<< "File: " << arg << '\n'
+			<< "Number of visited fields: "
+			<< aoc::profile("part1", [&] { return countVisitedFields(board); }) << '\n'
+			<< "Number of looping obstacles: "
+			<< aoc::profile("part2", [&] { return countLoopingObstacles(board); }) << '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
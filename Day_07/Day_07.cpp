@@ -1,11 +1,13 @@
 ﻿#include <iostream>
 #include <vector>
-#include <sstream>
 #include <functional>
 #include <numeric>
-#include <execution>
 #include <cmath>
 #include "utils.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
+#include "ThreadPool.hpp"
+#include "StreamReader.hpp"
 
 
 #define CUT_UNCORRECT_BRANCHES 1
@@ -18,6 +20,8 @@
 	#endif
 #endif
 
+namespace day07 {
+
 class Equation
 {
 public:
@@ -103,10 +107,10 @@ using Equations = std::vector<Equation>;
 class EquationParser
 {
 public:
-	Equations parseEquations(const std::vector<std::string>& equations) const
+	Equations parseEquations(const aoc::MappedInput& equations) const
 	{
 		std::vector<Equation> result;
-		for (const auto& equation : equations) {
+		for (std::string_view equation : equations) {
 			Equation parsedEquation = parseEquation(equation);
 			result.emplace_back(parsedEquation);
 		}
@@ -115,22 +119,21 @@ public:
 	}
 
 
-	Equation parseEquation(const std::string& equation) const
+	Equation parseEquation(std::string_view equation) const
 	{
-		std::stringstream ss(equation);
-		Equation::ResultT result;
-		char separator;
-		ss >> result >> separator;
-		
-		
+		aoc::Scanner scanner{ equation };
+		Equation::ResultT result{};
+		bool hasResult = scanner.tryNextInt(result) && scanner.skip(':');
+
 		std::vector<Equation::ElemT> elements;
 		Equation::ElemT element;
-		while (ss >> element) {
+		while (scanner.tryNextInt(element)) {
 			elements.push_back(element);
 		}
 
-		if (separator != ':' || (ss.fail() && !ss.eof())) {
-			std::string message = "Equation" + equation + " is ill formed!";
+		scanner.skipWhitespace();
+		if (!hasResult || !scanner.atEnd()) {
+			std::string message = "Equation" + std::string(equation) + " is ill formed!";
 			throw std::invalid_argument(message);
 		}
 
@@ -155,6 +158,32 @@ public:
 	}
 
 
+	// Both sums for a file read in batches of fixed size, each batch is checked in parallel
+	std::pair<uint64_t, uint64_t> sumValidEquationsStreaming(aoc::StreamReader& reader, const EquationParser& parser) const
+	{
+		static constexpr size_t BATCH_SIZE = 1024;
+		uint64_t sumAddMul{};
+		uint64_t sumAddMulCon{};
+		Equations batch;
+		batch.reserve(BATCH_SIZE);
+		auto solveBatch = [&] {
+			sumAddMul += sumValidEquationsAddMul(batch);
+			sumAddMulCon += sumValidEquationsAddMulCon(batch);
+			batch.clear();
+		};
+
+		reader.forEachLine([&](std::string_view line) {
+			batch.push_back(parser.parseEquation(line));
+			if (batch.size() == BATCH_SIZE) {
+				solveBatch();
+			}
+		});
+		solveBatch();
+
+		return { sumAddMul, sumAddMulCon };
+	}
+
+
 private:
 	uint64_t sumValidEquations(
 		const Equations& equations,
@@ -170,16 +199,18 @@ private:
 		}
 		return sum;
 #else
-		return std::transform_reduce(std::execution::par_unseq, 
-			equations.begin(), equations.end(), 
-			0ull,
-			std::plus<uint64_t>(),
-			[&ops](const Equation& eq) -> uint64_t {
-				if (eq.isValid(ops)) {
-					return eq.getResult();
+		// Single equations differ in cost by orders of magnitude, so each one is a separate chunk
+		return aoc::parallelReduce(size_t{}, equations.size(), 1, 0ull,
+			[&equations, &ops](size_t begin, size_t end) -> uint64_t {
+				uint64_t sum{};
+				for (size_t i = begin; i < end; ++i) {
+					if (equations[i].isValid(ops)) {
+						sum += equations[i].getResult();
+					}
 				}
-				return 0ull;
-			});
+				return sum;
+			},
+			std::plus<uint64_t>());
 #endif
 	}
 
@@ -207,40 +238,79 @@ private:
 	};
 };
 
+class Day07Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_equations = EquationParser().parseEquations(input);
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(BridgeRepairSolution().sumValidEquationsAddMul(m_equations));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(BridgeRepairSolution().sumValidEquationsAddMulCon(m_equations));
+	}
+
+private:
+	Equations m_equations;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day07Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day07;
+
 	auto runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runArgs, "--stream");
 
 	if (runArgs.empty()) {
 		std::cerr << "No arguments given!";
 		return 1;
 	}
 
-	EquationParser eqParser;
-	BridgeRepairSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			std::vector<std::string> lines = aoc::loadFile(arg);
-			std::vector<Equation> equations = eqParser.parseEquations(lines);
-
-			
-			aoc::SimpleClock c;
-			c.start();
-			std::cout << "For file " << arg << std::endl
-				<< "Sum of valid equations using (+, *): "
-				<< solution.sumValidEquationsAddMul(equations) << std::endl;
-			c.end();
-
-			c.start();
-			std::cout << "Sum of valid equations using (+, *, ||): " 
-				<< solution.sumValidEquationsAddMulCon(equations) << std::endl;
-			c.end();
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		EquationParser eqParser;
+		BridgeRepairSolution solution;
+		if (streaming) {
+			aoc::StreamReader reader(arg);
+			auto [sumAddMul, sumAddMulCon] = aoc::profile("stream", [&] { return solution.sumValidEquationsStreaming(reader, eqParser); });
+			out << "For file " << arg << '\n'
+				<< "Sum of valid equations using (+, *): " << sumAddMul << '\n'
+				<< "Sum of valid equations using (+, *, ||): " << sumAddMulCon << '\n';
+			return;
 		}
-		catch (std::exception& e) {
-			std::cout << e.what();
-		}
-		
-	}
+
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		std::vector<Equation> equations = aoc::profile("parse", [&] { return eqParser.parseEquations(input); });
+
+		out << "For file " << arg << '\n'
+			<< "Sum of valid equations using (+, *): "
+			<< aoc::profile("part1", [&] { return solution.sumValidEquationsAddMul(equations); }) << '\n';
+
+		out << "Sum of valid equations using (+, *, ||): " 
+			<< aoc::profile("part2", [&] { return solution.sumValidEquationsAddMulCon(equations); }) << '\n';
+	});
 	return 0;
-}
\ No newline at end of file
+}
+#endif
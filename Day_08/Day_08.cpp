@@ -1,9 +1,13 @@
 ﻿#include <iostream>
-#include <unordered_map>
-#include <unordered_set>
 #include <algorithm>
-#include <execution>
+#include <optional>
 #include "utils.hpp"
+#include "Solver.hpp"
+#include "Batch.hpp"
+#include "FlatHash.hpp"
+#include "BitGrid.hpp"
+
+namespace day08 {
 
 struct Vec2D
 {
@@ -21,22 +25,24 @@ struct Position
 	Position operator+(const Vec2D& v) const { return { x + v.x, y + v.y }; }
 	Position operator+=(const Vec2D& v) { return *this = *this + v; }
 };
+}
 
 template<>
-struct std::hash<Position>
+struct std::hash<day08::Position>
 {
-	std::size_t operator() (const Position& p) const 
+	std::size_t operator() (const day08::Position& p) const 
 	{
-		return std::hash<int>()(p.x) ^ hash<int>()(p.y) << 1;
+		return aoc::combineHash(aoc::mixHash(p.x), p.y);
 	}
 };
 
+namespace day08 {
 
 class AntennaMap
 {
 public:
 	using FreqName = char;
-	using DataMap = std::unordered_map<FreqName, std::vector<Position>>;
+	using DataMap = aoc::FlatMap<FreqName, std::vector<Position>>;
 	AntennaMap(size_t sizeX, size_t sizeY, const DataMap& antennaPositions) 
 		: m_sizeX{ sizeX }, 
 		m_sizeY{ sizeY },
@@ -51,9 +57,7 @@ public:
 
 	void displayVisualizationWithNodes() const 
 	{
-		std::vector<std::string> lines(m_sizeY);
-		std::for_each(std::execution::par, lines.begin(), lines.end(),
-			[this](std::string& line) { line = std::string(m_sizeX, '.');});
+		std::vector<std::string> lines(m_sizeY, std::string(m_sizeX, '.'));
 
 		for (const auto& [freqName, positions] : m_antennaPositions) {
 			for (const auto& pos : positions) {
@@ -61,47 +65,59 @@ public:
 			}
 		}
 
-		const auto& nodes = getAntinodes();
-		for (const auto& node : nodes) {
-			lines[node.y][node.x] = '#';
-		}
+		getAntinodes().forEach([&lines](size_t x, size_t y) {
+			lines[y][x] = '#';
+		});
 
 		for (const auto& line : lines) {
 			std::cout << line << std::endl;
 		}
 	}
 
-	std::unordered_set<Position> getAntinodes() const
+	aoc::BitGrid getAntinodes() const
 	{
-		std::unordered_set<Position> result;
+		aoc::BitGrid result(m_sizeX, m_sizeY);
 		for (const auto& [freq, pos] : m_antennaPositions) {
-			const auto& antinodes = getAntinodes(freq);
-			result.insert(antinodes.begin(), antinodes.end());
+			addAntinodes(freq, result);
 		}
 
 		return result;
 	}
 
-	std::unordered_set<Position> getAntinodesInLine() const
+	aoc::BitGrid getAntinodesInLine() const
 	{
-		std::unordered_set<Position> result;
+		aoc::BitGrid result(m_sizeX, m_sizeY);
 		for (const auto& [freq, pos] : m_antennaPositions) {
-			const auto& antinodes = getAntinodesInLine(freq);
-			result.insert(antinodes.begin(), antinodes.end());
+			addAntinodesInLine(freq, result);
 		}
 
 		return result;
 	}
 
-	std::unordered_set<Position> getAntinodes(FreqName freqName) const
+	aoc::BitGrid getAntinodes(FreqName freqName) const
+	{
+		aoc::BitGrid antinodePositions(m_sizeX, m_sizeY);
+		addAntinodes(freqName, antinodePositions);
+		return antinodePositions;
+	}
+
+	aoc::BitGrid getAntinodesInLine(FreqName freqName) const
+	{
+		aoc::BitGrid antinodePositions(m_sizeX, m_sizeY);
+		addAntinodesInLine(freqName, antinodePositions);
+		return antinodePositions;
+	}
+
+
+private:
+	// Antinodes of all frequencies go into one grid, overlapping ones are counted once
+	void addAntinodes(FreqName freqName, aoc::BitGrid& antinodePositions) const
 	{
 		if (!m_antennaPositions.contains(freqName)) {
-			return {};
+			return;
 		}
 
-		std::unordered_set<Position> antinodePositions;
 		const auto& freqPositions = m_antennaPositions.at(freqName);
-
 		for (const Position& aPos : freqPositions) {
 			for (const Position& bPos : freqPositions) {
 				if (&aPos == &bPos) {
@@ -111,23 +127,19 @@ public:
 				Vec2D offset = bPos - aPos;
 				Position antinodePos = bPos + offset;
 				if (contains(antinodePos)) {
-					antinodePositions.insert(antinodePos);
+					antinodePositions.set(antinodePos.x, antinodePos.y);
 				}
 			}
 		}
-
-		return antinodePositions;
 	}
 
-	std::unordered_set<Position> getAntinodesInLine(FreqName freqName) const
+	void addAntinodesInLine(FreqName freqName, aoc::BitGrid& antinodePositions) const
 	{
 		if (!m_antennaPositions.contains(freqName)) {
-			return {};
+			return;
 		}
 
-		std::unordered_set<Position> antinodePositions;
 		const auto& freqPositions = m_antennaPositions.at(freqName);
-
 		for (const Position& aPos : freqPositions) {
 			for (const Position& bPos : freqPositions) {
 				if (&aPos == &bPos) {
@@ -137,17 +149,13 @@ public:
 				Vec2D offset = bPos - aPos;
 				Position antinodePos = bPos;
 				while (contains(antinodePos)) {
-					antinodePositions.insert(antinodePos);
+					antinodePositions.set(antinodePos.x, antinodePos.y);
 					antinodePos += offset;
 				}
 			}
 		}
-
-		return antinodePositions;
 	}
 
-
-private:
 	bool contains(const Position& p) const 
 	{
 		return p.y >= 0 && p.y < m_sizeY && p.x >= 0 && p.x < m_sizeX;
@@ -164,12 +172,12 @@ class ResonantCollinearitySolution
 public:
 	size_t countAntinodesLocation(const AntennaMap& map) const 
 	{
-		return map.getAntinodes().size();
+		return map.getAntinodes().count();
 	}
 
 	size_t countAntinodesInLines(const AntennaMap& map) const
 	{
-		return map.getAntinodesInLine().size();
+		return map.getAntinodesInLine().count();
 	}
 };
 
@@ -177,7 +185,7 @@ public:
 class AntennaParser
 {
 public:
-	AntennaMap parseMap(const std::vector<std::string>& mapLines)
+	AntennaMap parseMap(const std::vector<std::string_view>& mapLines)
 	{
 		if (mapLines.empty()) {
 			throw std::runtime_error("Map is empty!");
@@ -206,36 +214,70 @@ private:
 	static constexpr char emptyChar = '.';
 };
 
+class Day08Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_map.emplace(AntennaParser().parseMap(input.lines()));
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(ResonantCollinearitySolution().countAntinodesLocation(m_map.value()));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(ResonantCollinearitySolution().countAntinodesInLines(m_map.value()));
+	}
+
+private:
+	std::optional<AntennaMap> m_map;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day08Solver>();
+}
+}
 
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day08;
+
 	auto runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		std::cerr << "No arguments given!";
 		return 1;
 	}
 
-	AntennaParser parser;
-	for (const std::string& arg : runArgs) {
-		try {
-			auto dataLines = aoc::loadFile(arg);
-			AntennaMap map = parser.parseMap(dataLines);
-
-			ResonantCollinearitySolution solution;
-			std::cout << "File " << arg << ": " << std::endl
-				<< "\tUnique antinodes: " 
-				<< solution.countAntinodesLocation(map)
-				<< std::endl
-				<< "\tUnique antinodes in lines: "
-				<< solution.countAntinodesInLines(map)
-				<< std::endl;
-		}
-		catch (std::exception& e) {
-			std::cout << e.what();
-		}
-
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		AntennaParser parser;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		AntennaMap map = aoc::profile("parse", [&] { return parser.parseMap(input.lines()); });
+
+		ResonantCollinearitySolution solution;
+		out << "File " << arg << ": " << '\n'
+			<< "\tUnique antinodes: " 
+			<< aoc::profile("part1", [&] { return solution.countAntinodesLocation(map); })
+			<< '\n'
+			<< "\tUnique antinodes in lines: "
+			<< aoc::profile("part2", [&] { return solution.countAntinodesInLines(map); })
+			<< '\n';
+	});
 	return 0;
 }
+#endif
@@ -1,6 +1,10 @@
 ﻿#include <list>
 #include <cmath>
 #include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+
+namespace day09 {
 
 struct Segment
 {
@@ -203,7 +207,7 @@ public:
 class MemoryParser
 {
 public:
-	Memory parseMemory(const std::string& line)
+	Memory parseMemory(std::string_view line)
 	{
 		Memory memory;
 		bool isEmptySpace = false;
@@ -223,34 +227,80 @@ public:
 	}
 };
 
+class Day09Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_memory = MemoryParser().parseMemory(*input.begin());
+	}
+
+	std::string part1() override
+	{
+		Memory squished = m_memory;
+		SquishyFragmenter().organize(squished);
+		return std::to_string(squished.controlSum());
+	}
+
+	std::string part2() override
+	{
+		Memory defragmented = m_memory;
+		SpaciousDefragmenter().organize(defragmented);
+		return std::to_string(defragmented.controlSum());
+	}
+
+private:
+	Memory m_memory;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day09Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day09;
+
 	std::vector<std::string> runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		std::cerr << "No files to run given!";
 		return 1;
 	}
 
-	MemoryParser parser;
-	SquishyFragmenter fragmenter;
-	SpaciousDefragmenter defragmenter;
-	for (const auto& arg : runArgs) {
-		for (const auto& line : aoc::loadFile(arg)) {
-			
-			Memory memory{ parser.parseMemory(line) };
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		MemoryParser parser;
+		SquishyFragmenter fragmenter;
+		SpaciousDefragmenter defragmenter;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		for (std::string_view line : input) {
+
+			Memory memory = aoc::profile("parse", [&] { return Memory{ parser.parseMemory(line) }; });
 			Memory squished = memory;
 			Memory defragmented = memory;
-			fragmenter.organize(squished);
-			defragmenter.organize(defragmented);
-			std::cout << "For file " << arg << ": " << std::endl
+			aoc::profile("part1", [&] { fragmenter.organize(squished); });
+			aoc::profile("part2", [&] { defragmenter.organize(defragmented); });
+			out << "For file " << arg << ": " << '\n'
 				<< "Control sum after squishy fragmentation: "
 				<< squished.controlSum()
 				<< "Control sum after defragmentation: "
 				<< defragmented.controlSum();
 		}
-	}
+	});
 
 	return 0;
 }
+#endif
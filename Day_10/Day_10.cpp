@@ -1,9 +1,15 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <Grid.hpp>
+#include <FlatHash.hpp>
+#include <ThreadPool.hpp>
+#include <GridSearch.hpp>
 #include <iostream>
 #include <stack>
-#include <unordered_set>
 #include <numeric>
-#include <execution>
+
+namespace day10 {
 
 using namespace aoc;
 
@@ -11,28 +17,25 @@ class HeightMap
 {
 public:
 	using Height = int32_t;
+	using Index = Grid<Height>::Index;
 	static constexpr Height HEIGHT_MAX = INT32_MAX;
 	static constexpr Height trialhead = 0;
 	static constexpr Height finishHeihgt = 9;
 
 	HeightMap() = default;
 
-	HeightMap(const std::vector<std::vector<Height>>& heights)
-		: m_heights{heights}
-	{}
-
-	HeightMap(std::vector<std::vector<Height>>&& heights)
+	// heights should be surrounded by HEIGHT_MAX border, so no step leads outside
+	HeightMap(Grid<Height>&& heights)
 		: m_heights{std::move(heights)}
 	{}
 
-	std::vector<Position> getTrialheads() const {
-		std::vector<Position> positions;
-		for (int y = 0; y < sizeY(); ++y) {
-			for (int x = 0; x < sizeX(y); ++x) {
-				Position field{ x,y };
-				Height fieldHeight = at(field);
-				if (fieldHeight == trialhead) {
-					positions.push_back({ x,y });
+	std::vector<Index> getTrialheads() const {
+		std::vector<Index> positions;
+		for (int64_t y = 0; y < (int64_t)sizeY(); ++y) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); ++x) {
+				Index field = m_heights.index(x, y);
+				if (at(field) == trialhead) {
+					positions.push_back(field);
 				}
 			}
 		}
@@ -40,33 +43,38 @@ public:
 		return positions;
 	}
 
-	Height at(Position p) const {
-		return contains(p) ? m_heights[p.y][p.x] : HEIGHT_MAX;
+	Height at(Index idx) const {
+		return m_heights[idx];
 	}
 
-	bool isTrialHead(Position p) const {
-		return at(p) == trialhead;
+	bool isTrialHead(Index idx) const {
+		return at(idx) == trialhead;
 	}
 
-	bool isFinishPoint(Position p) const {
-		return at(p) == finishHeihgt;
+	bool isFinishPoint(Index idx) const {
+		return at(idx) == finishHeihgt;
 	}
 
-	bool contains(Position p) const {
-		return p.y >= 0 && p.y < sizeY() && p.x >= 0 && p.x < sizeX(p.y);
+	std::array<Grid<Height>::Offset, 4> neighbourOffsets() const {
+		return m_heights.neighbourOffsets();
 	}
 
-	size_t sizeX(int row = 0) const {
-		return m_heights.at(0).size();
+	const Grid<Height>& heights() const {
+		return m_heights;
+	}
+
+	size_t sizeX() const {
+		return m_heights.sizeX();
 	}
 
 	size_t sizeY() const {
-		return m_heights.size();
+		return m_heights.sizeY();
 	}
 
 	void display() {
-		for (auto r : m_heights) {
-			for (auto e : r) {
+		for (int64_t y = 0; y < (int64_t)sizeY(); ++y) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); ++x) {
+				Height e = m_heights.at({ x,y });
 				if (e < HEIGHT_MAX) {
 					std::cout << e << " ";
 				}
@@ -78,31 +86,22 @@ public:
 		}
 	}
 private:
-	std::vector<std::vector<Height>> m_heights;
+	Grid<Height> m_heights;
 };
 
 class HeihgtMapParser 
 {
 public:
-	HeightMap parseHeightMap(const std::vector<std::string>& lines)
+	HeightMap parseHeightMap(const aoc::MappedInput& lines)
 	{
 		if (lines.empty()) {
 			return {};
 		}
 
-		std::vector<std::vector<HeightMap::Height>> heights;
-		for (const std::string& line : lines) {
-			std::vector<HeightMap::Height> row;
-			for (char c : line) {
-				if (isdigit(c))
-					row.push_back(atoi(&c));
-				else
-					row.push_back(HeightMap::HEIGHT_MAX);
-			}
-			heights.push_back(std::move(row));
-		}
-
-		return HeightMap{ std::move(heights) };
+		auto toHeight = [](char c) {
+			return isdigit(c) ? HeightMap::Height(c - '0') : HeightMap::HEIGHT_MAX;
+		};
+		return HeightMap{ Grid<HeightMap::Height>::fromLines(lines, toHeight, 1, HeightMap::HEIGHT_MAX) };
 	}
 };
 
@@ -113,77 +112,66 @@ public:
 	uint32_t trialheadsScoreSum(const HeightMap& map) const 
 	{
 		auto heads = map.getTrialheads();
-		return std::transform_reduce(std::execution::par,
-			heads.begin(), heads.end(), 0ull,
-			std::plus<uint64_t>(),
-			[this, &map](const Position& p) -> uint64_t {
-				return trialheadScore(map, p);
-		});
+		return aoc::parallelReduce(size_t{}, heads.size(), 0, 0ull,
+			[this, &map, &heads](size_t begin, size_t end) -> uint64_t {
+				uint64_t sum{};
+				for (size_t i = begin; i < end; ++i) {
+					sum += trialheadScore(map, heads[i]);
+				}
+				return sum;
+			},
+			std::plus<uint64_t>());
 	}
 
 	uint32_t trialheadsRatingsSum(const HeightMap& map) const {
 		auto heads = map.getTrialheads();
-		return std::transform_reduce(std::execution::par,
-			heads.begin(), heads.end(), 0ull,
-			std::plus<uint64_t>(),
-			[this, &map](const Position& p) -> uint64_t {
-				return trialheadRating(map, p);
-			});
+		return aoc::parallelReduce(size_t{}, heads.size(), 0, 0ull,
+			[this, &map, &heads](size_t begin, size_t end) -> uint64_t {
+				uint64_t sum{};
+				for (size_t i = begin; i < end; ++i) {
+					sum += trialheadRating(map, heads[i]);
+				}
+				return sum;
+			},
+			std::plus<uint64_t>());
 	}
 
 private:
-	uint32_t trialheadScore(const HeightMap& map, Position trialheadPos) const
+	uint32_t trialheadScore(const HeightMap& map, HeightMap::Index trialheadPos) const
 	{
 		if (!map.isTrialHead(trialheadPos)) {
 			return {};
 		}
 
-		std::unordered_set<Position> visited;
-		std::stack<Position> stack;
+		// Reused by every trialhead the thread scores
+		thread_local aoc::GridSearch search;
 		uint32_t score{};
-		
-		stack.push(trialheadPos);
-		while (!stack.empty()) {
-			Position currPos = stack.top();
-			stack.pop();
-
-			Vec2D offsets[] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-			for (const Vec2D& offset : offsets) {
-				auto newPos = currPos + offset;
-
-				if (isStepUp(map, currPos, newPos) && !visited.contains(newPos)) {
-					if (map.isFinishPoint(newPos)) {
-						visited.insert(newPos);
-						score++;
-					}
-					else {
-						stack.push(newPos);
-					}
-				}
-			}
-
-			visited.insert(currPos);
-		}
+		aoc::gridBfs(search, map.heights(), trialheadPos,
+			[this, &map](HeightMap::Index from, HeightMap::Index to) { return isStepUp(map, from, to); },
+			[&map, &score](HeightMap::Index idx, aoc::GridSearch::Distance) {
+				score += map.isFinishPoint(idx);
+				return true;
+			});
 
 		return score;
 	}
 
-	uint32_t trialheadRating(const HeightMap& map, Position trialheadPos) const
+	uint32_t trialheadRating(const HeightMap& map, HeightMap::Index trialheadPos) const
 	{
 		if (!map.isTrialHead(trialheadPos)) {
 			return {};
 		}
 
-		std::stack<Position> stack;
+		std::stack<HeightMap::Index> stack;
 		uint32_t rating{};
 
 		stack.push(trialheadPos);
+		const auto offsets = map.neighbourOffsets();
 		while (!stack.empty()) {
-			Position currPos = stack.top();
+			HeightMap::Index currPos = stack.top();
 			stack.pop();
 
-			Vec2D offsets[] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
-			for (const Vec2D& offset : offsets) {
+			for (auto offset : offsets) {
 				auto newPos = currPos + offset;
 
 				if (isStepUp(map, currPos, newPos)) {
@@ -200,32 +188,74 @@ private:
 		return rating;
 	}
 
-	bool isStepUp(const HeightMap& hMap, Position from, Position goal) const
+	bool isStepUp(const HeightMap& hMap, HeightMap::Index from, HeightMap::Index goal) const
 	{
 		return hMap.at(goal) == hMap.at(from) + 1;
 	}
 };
 
+class Day10Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_map = HeihgtMapParser().parseHeightMap(input);
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(HeihgtMapPathFinder().trialheadsScoreSum(m_map));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(HeihgtMapPathFinder().trialheadsRatingsSum(m_map));
+	}
+
+private:
+	HeightMap m_map;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day10Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day10;
+
 	std::vector<std::string> runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		std::cout << "No arguments given! Running default file." << std::endl;
 		runArgs.push_back("input.txt");
 	}
 
-	HeihgtMapParser parser;
-	HeihgtMapPathFinder finder;
-	for (const std::string& arg : runArgs) {
-		std::vector<std::string> lines{ aoc::loadFile(arg) };
-		HeightMap map = parser.parseHeightMap(lines);
-		std::cout << "For file " << arg << std::endl
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		HeihgtMapParser parser;
+		HeihgtMapPathFinder finder;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		HeightMap map = aoc::profile("parse", [&] { return parser.parseHeightMap(input); });
+		out << "For file " << arg << '\n'
 			<< "Total trialheads score: "
-			<< finder.trialheadsScoreSum(map) << std::endl
+			<< aoc::profile("part1", [&] { return finder.trialheadsScoreSum(map); }) << '\n'
 			<< "Total trialheads rating: "
-			<< finder.trialheadsRatingsSum(map) << std::endl;
-	}
+			<< aoc::profile("part2", [&] { return finder.trialheadsRatingsSum(map); }) << '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,6 +1,10 @@
 ﻿#include <utils.hpp>
-#include <sstream>
-#include <unordered_map>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <ThreadPool.hpp>
+#include <MemoTable.hpp>
+
+namespace day11 {
 
 struct Stone
 {
@@ -10,29 +14,49 @@ struct Stone
 	}
 };
 
+struct StoneBlinks
+{
+	uint64_t number;
+	uint64_t blinksLeft;
+	bool operator==(const StoneBlinks&) const = default;
+};
+}
+
 template<>
-struct std::hash<Stone>
+struct std::hash<day11::Stone>
 {
-	std::size_t operator() (const Stone& s) const
+	std::size_t operator() (const day11::Stone& s) const
 	{
 		return hash<uint64_t>()(s.number);
 	}
 };
 
+template<>
+struct std::hash<day11::StoneBlinks>
+{
+	std::size_t operator() (const day11::StoneBlinks& s) const
+	{
+		return aoc::combineHash(aoc::mixHash(s.number), s.blinksLeft);
+	}
+};
+
+namespace day11 {
+
 class StonesParser
 {
 public:
-	std::vector<Stone> parseStones(const std::string& line)
+	std::vector<Stone> parseStones(std::string_view line)
 	{
 		std::vector<Stone> parsedStones;
-		std::stringstream ss(line);
-		
+		aoc::Scanner scanner{ line };
+
 		uint64_t num;
-		while (ss >> num) {
+		while (scanner.tryNextInt(num)) {
 			parsedStones.emplace_back(num);
 		}
 
-		if (ss.fail() && !ss.eof()) {
+		scanner.skipWhitespace();
+		if (!scanner.atEnd()) {
 			throw std::runtime_error("Provided input is ill formated!");
 		}
 
@@ -43,29 +67,34 @@ public:
 class StonesBlinker
 {
 public:
+	// Stones are counted in parallel, the memo is shared between them
 	uint64_t countStonesAfter(const std::vector<Stone>& stones, uint64_t blinkNum)
 	{
-		uint64_t sum{};
-		for (auto& stone : stones) {
-			sum += countStones(stone, blinkNum);
-		}
-
-		return sum;
+		return aoc::parallelReduce(size_t{}, stones.size(), 1, uint64_t{},
+			[&](size_t begin, size_t end) {
+				uint64_t sum{};
+				for (size_t i = begin; i < end; ++i) {
+					sum += countStones(stones[i], blinkNum);
+				}
+				return sum;
+			},
+			std::plus<uint64_t>());
 	}
 
 private:
 	uint64_t countStones(const Stone& stone, uint64_t blinksLeft)
 	{
-		if (m_mem.contains(stone)) {
-			if (m_mem[stone].contains(blinksLeft)) {
-				return m_mem[stone][blinksLeft];
-			}
-		}
-
 		if (blinksLeft == 0) {
 			return 1;
 		}
-		
+
+		return m_mem.getOrCompute({ stone.number, blinksLeft }, [&] {
+			return blink(stone, blinksLeft);
+		});
+	}
+
+	uint64_t blink(const Stone& stone, uint64_t blinksLeft)
+	{
 		uint64_t num = stone.number;
 		uint64_t result;
 		if (num == 0) {
@@ -82,42 +111,77 @@ private:
 			result = countStones({num * m_mulContant}, blinksLeft - 1);
 		}
 
-		return m_mem[stone][blinksLeft] = result;
+		return result;
 	}
 
 	static constexpr uint64_t m_mulContant = 2024;
-	static std::unordered_map<Stone, std::unordered_map<uint64_t, uint64_t>> m_mem;
+	// 75 blinks of a real input reach about 130k distinct states
+	static constexpr size_t m_memCapacity = size_t{ 1 } << 20;
+	aoc::MemoTable<StoneBlinks, uint64_t> m_mem{ m_memCapacity };
 };
 
-std::unordered_map<Stone, std::unordered_map<uint64_t, uint64_t>> StonesBlinker::m_mem;
+class Day11Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_stones = StonesParser().parseStones(input.lines().at(0));
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(StonesBlinker().countStonesAfter(m_stones, 25));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(StonesBlinker().countStonesAfter(m_stones, 75));
+	}
+
+private:
+	std::vector<Stone> m_stones;
+};
 
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day11Solver>();
+}
+}
 
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day11;
+
 	std::vector<std::string> runArgs{ aoc::argsToString(argc - 1, args + 1) };
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		std::cout << "No arguments given! Running default file." << std::endl;
 		runArgs.push_back("example.txt");
 	}
 
-	StonesParser parser;
-	StonesBlinker blinker;
-	for (const std::string& arg : runArgs) {
-		try {
-			std::string line{ aoc::loadFile(arg).at(0) };
-			std::vector<Stone> stones = parser.parseStones(line);
-			const uint64_t blinkNum = 75;
-
-			std::cout << "In file " << arg << std::endl
-				<< "For " << blinkNum << " blinks: " 
-				<< blinker.countStonesAfter(stones, 75) << std::endl;
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		StonesParser parser;
+		StonesBlinker blinker;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		std::vector<Stone> stones = aoc::profile("parse", [&] { return parser.parseStones(input.lines().at(0)); });
+		const uint64_t blinkNum = 75;
+
+		out << "In file " << arg << '\n'
+			<< "For " << blinkNum << " blinks: " 
+			<< aoc::profile("part2", [&] { return blinker.countStonesAfter(stones, 75); }) << '\n';
+	});
 
 	return 0;
 }
+#endif
@@ -1,83 +1,15 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <Grid.hpp>
+#include <FlatHash.hpp>
+#include <Arena.hpp>
+#include <GridSearch.hpp>
+#include <DisjointSet.hpp>
 #include <vector>
-#include <queue>
-
-template<typename T>
-class RectangularBoard
-{
-public:
-	RectangularBoard(size_t sizeX, size_t sizeY)
-		: m_fields(sizeY, std::vector<T>(sizeY))
-	{}
-
-	RectangularBoard(const std::vector<std::vector<T>>& fields)
-		: m_fields{ fields }
-	{
-		if (!isRectangular()) {
-			throw std::invalid_argument("Garden is not rectangular!");
-		}
-	}
-
-	RectangularBoard(std::vector<std::vector<T>>&& fields)
-		: m_fields{ fields }
-	{
-		if (!isRectangular()) {
-			throw std::invalid_argument("Garden is not rectangular!");
-		}
-	}
-
-	bool contains(const aoc::Position& p) const {
-		return p.y >= 0 && p.y < sizeY() && p.x >= 0 && p.x < sizeX();
-	}
-
-	T at(const aoc::Position& p) const {
-		return m_fields[p.y][p.x];
-	}
-
-	void setAt(const aoc::Position& p, T val) {
-		if (contains(p)) {
-			m_fields[p.y][p.x] = val;
-		}
-	}
-
-	size_t sizeX() const {
-		return m_fields[0].size();
-	}
-
-	size_t sizeY() const {
-		return m_fields.size();
-	}
-
-	void print() const 
-	{
-		for (const auto& row : m_fields) {
-			for (const auto& el : row) {
-				std::cout << el;
-			}
-			std::cout << std::endl;
-		}
-	}
-
-protected:
-	bool isRectangular() 
-	{
-		if (m_fields.empty()) {
-			return false;
-		}
-
-		const auto& firstRow = m_fields.front();
-		for (const auto& row : m_fields) {
-			if (row.size() != firstRow.size()) {
-				return false;
-			}
-		}
-
-		return true;
-	}
-
-	std::vector<std::vector<T>> m_fields;
-};
+#include <optional>
 
+namespace day12 {
 
 class GardenArea
 {
@@ -86,11 +18,11 @@ public:
 		: m_name{}, m_fields{} 
 	{}
 
-	GardenArea(char name, const std::unordered_set<aoc::Position>& fields)
+	GardenArea(char name, const aoc::pmr::FlatSet<aoc::Position>& fields)
 		: m_name{ name }, m_fields{ fields }
 	{}
 
-	GardenArea(char name, std::unordered_set<aoc::Position>&& fields)
+	GardenArea(char name, aoc::pmr::FlatSet<aoc::Position>&& fields)
 		: m_name{name}, m_fields {std::move(fields)}
 	{}
 
@@ -98,13 +30,13 @@ public:
 		return m_name;
 	}
 
-	const std::unordered_set<aoc::Position>& getFieldPositions() const {
+	const aoc::pmr::FlatSet<aoc::Position>& getFieldPositions() const {
 		return m_fields;
 	}
 
-	std::unordered_set<aoc::Position> getBorderFields() const 
+	aoc::pmr::FlatSet<aoc::Position> getBorderFields() const 
 	{
-		std::unordered_set<aoc::Position> borderPositions;
+		aoc::pmr::FlatSet<aoc::Position> borderPositions(m_fields.get_allocator());
 		for (const auto& field : m_fields) {
 			if (isBorder(field)) {
 				borderPositions.insert(field);
@@ -182,97 +114,89 @@ private:
 	}
 
 	char m_name;
-	std::unordered_set<aoc::Position> m_fields;
+	aoc::pmr::FlatSet<aoc::Position> m_fields;
 };
 
 
-class Garden : public RectangularBoard<char>
+// Surrounded by a border of m_outsideName, which no area is named with
+class Garden : public aoc::Grid<char>
 {
 public:
-	using RectangularBoard::RectangularBoard;
+	static constexpr char m_outsideName = '\0';
+
+	Garden(aoc::Grid<char>&& fields)
+		: aoc::Grid<char>{ std::move(fields) }
+	{}
+
+	GardenArea getAreaAt(const aoc::Position& pos, std::pmr::memory_resource* memory) const 
+	{
+		aoc::GridSearch search;
+		return getAreaAt(pos, memory, search);
+	}
 
-	GardenArea getAreaAt(const aoc::Position& pos) const 
+	// search is only working space, callers may reuse one for every area
+	GardenArea getAreaAt(const aoc::Position& pos, std::pmr::memory_resource* memory, aoc::GridSearch& search) const
 	{
 		if (!contains(pos)) {
 			return {};
 		}
 
-		std::unordered_set<aoc::Position> areaPositions{pos};
-		std::queue<aoc::Position> toVisit{ {pos} };
-		while (!toVisit.empty()) {
-			aoc::Position currPos = toVisit.front();
-			toVisit.pop();
-
-			auto neighbours = getValidNeighbors(currPos);
+		aoc::gridBfs(search, *this, index(pos), [this](Index from, Index to) {
+			return (*this)[to] == (*this)[from];
+		});
 
-			for (const auto& neighbour : neighbours) {
-				if (!areaPositions.contains(neighbour)) {
-					areaPositions.insert(neighbour);
-					toVisit.push(neighbour);
-				}
-			}
+		aoc::pmr::FlatSet<aoc::Position> areaPositions(memory);
+		areaPositions.reserve(search.visitOrder().size());
+		for (Index idx : search.visitOrder()) {
+			areaPositions.insert(position(idx));
 		}
 
 		char areaName = at(pos);
-		return GardenArea{ areaName, areaPositions };
+		return GardenArea{ areaName, std::move(areaPositions) };
 	}
 
-	std::vector<GardenArea> getAllAreas() const 
+	// Areas are labelled in one pass over the garden and come in the order
+	// of their first field, row by row
+	std::pmr::vector<GardenArea> getAllAreas(std::pmr::memory_resource* memory) const 
 	{
-		RectangularBoard<bool> visited(sizeX(), sizeY());
-		std::vector<GardenArea> gardenAreas;
-
-		for (int y = 0; y < visited.sizeY(); ++y) {
-			for (int x = 0; x < visited.sizeX(); ++x) {
-				aoc::Position pos{ x,y };
-				if (visited.at(pos) == 1) {
-					continue;
-				}
-
-				GardenArea area = getAreaAt(pos);
-				gardenAreas.push_back(area);
-				for (const auto& position : area.getFieldPositions()) {
-					visited.setAt(position, true);
+		aoc::DisjointSet regions = aoc::labelGrid(*this, [this](Index from, Index to) {
+			return (*this)[from] == (*this)[to];
+		});
+
+		static constexpr size_t noArea = SIZE_MAX;
+		std::vector<size_t> areaOfRoot(cellCount(), noArea);
+		std::pmr::vector<aoc::pmr::FlatSet<aoc::Position>> areaFields(memory);
+		std::vector<char> areaNames;
+		for (int64_t y = 0; y < (int64_t)sizeY(); ++y) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); ++x) {
+				Index idx = index(x, y);
+				Index root = regions.find(idx);
+				if (areaOfRoot[root] == noArea) {
+					areaOfRoot[root] = areaFields.size();
+					areaFields.emplace_back().reserve(regions.componentSize(root));
+					areaNames.push_back((*this)[idx]);
 				}
+				areaFields[areaOfRoot[root]].insert({ x,y });
 			}
 		}
 
-		return gardenAreas;
-	}
-
-private:
-	std::unordered_set<aoc::Position> getValidNeighbors(
-		const aoc::Position& position) const
-	{
-		auto neighbours = getNeighbours(position);
-		std::unordered_set<aoc::Position> validNeighbours;
-
-		for (const auto& neighbour : neighbours) {
-			if (isValidNeighbour(position, neighbour)) {
-				validNeighbours.insert(neighbour);
-			}
+		std::pmr::vector<GardenArea> gardenAreas(memory);
+		gardenAreas.reserve(areaFields.size());
+		for (size_t i = 0; i < areaFields.size(); ++i) {
+			gardenAreas.emplace_back(areaNames[i], std::move(areaFields[i]));
 		}
 
-		return validNeighbours;
+		return gardenAreas;
 	}
 
-	std::unordered_set<aoc::Position> getNeighbours(const aoc::Position& pos) const
+	void print() const 
 	{
-		std::unordered_set<aoc::Position> neighbours;
-		aoc::Vec2D offsets[]{ {0,-1}, {1, 0}, {0, 1}, {-1,0} };
-		for (const auto& offset : offsets) {
-			aoc::Position nPos = pos + offset;
-			neighbours.insert(nPos);
+		for (int64_t y = 0; y < (int64_t)sizeY(); ++y) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); ++x) {
+				std::cout << at({ x,y });
+			}
+			std::cout << std::endl;
 		}
-
-		return neighbours;
-	}
-
-	bool isValidNeighbour(
-		const aoc::Position pos, 
-		const aoc::Position& neigh) const 
-	{
-		return contains(pos) && contains(neigh) && at(pos) == at(neigh);
 	}
 };
 
@@ -280,16 +204,14 @@ private:
 class GardenParser 
 {
 public:
-	Garden parseGarden(const std::vector<std::string>& garden) const
+	Garden parseGarden(const aoc::MappedInput& garden) const
 	{
-		std::vector<std::vector<char>> fields;
-		for (auto& row : garden) {
-			fields.push_back({});
-			for (auto& fieldName : row) {
-				fields.back().push_back(fieldName);
-			}
+		if (garden.empty()) {
+			throw std::invalid_argument("Garden is empty!");
 		}
-		return Garden{fields};
+
+		auto fields = aoc::Grid<char>::fromLines(garden, [](char c) { return c; }, 1, Garden::m_outsideName);
+		return Garden{ std::move(fields) };
 	}
 };
 
@@ -297,10 +219,15 @@ public:
 class GardenValueCalculator
 {
 public:
+	// Areas found on the way are allocated from memory
+	explicit GardenValueCalculator(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+		: m_memory{ memory }
+	{}
+
 	uint64_t calculateValue(const Garden& g) const
 	{
 		uint64_t sum{};
-		std::vector<GardenArea> areas = g.getAllAreas();
+		std::pmr::vector<GardenArea> areas = g.getAllAreas(m_memory);
 		for (const auto& area : areas) {
 			sum += area.getArea() * area.getPerimeter();
 		}
@@ -310,18 +237,64 @@ public:
 	uint64_t calculateDiscountedValue(const Garden& g) const
 	{
 		uint64_t sum{};
-		std::vector<GardenArea> areas = g.getAllAreas();
+		std::pmr::vector<GardenArea> areas = g.getAllAreas(m_memory);
 		for (const auto& area : areas) {
 			sum += area.getArea() * area.getSidesCount();
 		}
 		return sum;
 	}
+
+private:
+	std::pmr::memory_resource* m_memory;
+};
+
+class Day12Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_garden.emplace(GardenParser().parseGarden(input));
+	}
+
+	std::string part1() override
+	{
+		m_arena.reset();
+		return std::to_string(GardenValueCalculator(&m_arena).calculateValue(m_garden.value()));
+	}
+
+	std::string part2() override
+	{
+		m_arena.reset();
+		return std::to_string(GardenValueCalculator(&m_arena).calculateDiscountedValue(m_garden.value()));
+	}
+
+private:
+	std::optional<Garden> m_garden;
+	aoc::Arena m_arena;
 };
 
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day12Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day12;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	
 	if (runArgs.empty()) {
 		const std::string defaultFile = "example.txt";
@@ -329,18 +302,19 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	GardenParser parser;
-	GardenValueCalculator calculator;
-	for (const std::string& arg : runArgs) {
-		std::vector<std::string> lines{ aoc::loadFile(arg) };
-		Garden garden = parser.parseGarden(lines);
-		std::cout << "Normal value: "
-			<< calculator.calculateValue(garden)
-			<< std::endl
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out, aoc::Arena& arena) {
+		GardenParser parser;
+		GardenValueCalculator calculator(&arena);
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		Garden garden = aoc::profile("parse", [&] { return parser.parseGarden(input); });
+		out << "Normal value: "
+			<< aoc::profile("part1", [&] { return calculator.calculateValue(garden); })
+			<< '\n'
 			<< "Discounted value: "
-			<< calculator.calculateDiscountedValue(garden)
-			<< std::endl;
-	}
+			<< aoc::profile("part2", [&] { return calculator.calculateDiscountedValue(garden); })
+			<< '\n';
+	});
 
 	return 0;
 }
+#endif
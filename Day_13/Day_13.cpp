@@ -1,7 +1,11 @@
 ﻿#include <utils.hpp>
-#include <regex>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <StreamReader.hpp>
 #include <unordered_map>
 
+namespace day13 {
+
 struct Button
 {
 	uint64_t cost;
@@ -38,13 +42,13 @@ private:
 class ClawMachineParser
 {
 public:
-	std::vector<ClawMachine> parseClawMachines(const std::vector<std::string>& lines) const
+	std::vector<ClawMachine> parseClawMachines(const std::vector<std::string_view>& lines) const
 	{
 		std::vector<ClawMachine> result;
 		for (int i = 0; i < lines.size(); i += 4) {
-			const std::string lineA = lines[i];
-			const std::string lineB = lines[i + 1];
-			const std::string linePrize = lines[i + 2];
+			std::string_view lineA = lines[i];
+			std::string_view lineB = lines[i + 1];
+			std::string_view linePrize = lines[i + 2];
 			ClawMachine machine = parseClawMachine(lineA, lineB, linePrize);
 			result.emplace_back(std::move(machine));
 		}
@@ -52,10 +56,20 @@ public:
 		return result;
 	}
 
+	// One machine's three lines as a single record
+	ClawMachine parseClawMachine(std::string_view record) const
+	{
+		std::vector<std::string_view> lines = aoc::splitLines(record);
+		if (lines.size() != 3) {
+			throw std::invalid_argument("Claw machine should have 3 lines: " + std::string(record));
+		}
+		return parseClawMachine(lines[0], lines[1], lines[2]);
+	}
+
 	ClawMachine parseClawMachine(
-		const std::string& lineButtonA,
-		const std::string& lineButtonB,
-		const std::string& linePrizePos) const
+		std::string_view lineButtonA,
+		std::string_view lineButtonB,
+		std::string_view linePrizePos) const
 	{
 		aoc::Position btnPosA = parsePos(lineButtonA);
 		aoc::Position btnPosB = parsePos(lineButtonB);
@@ -67,23 +81,24 @@ public:
 	}
 
 private:
-	aoc::Position parsePos(const std::string& line) const
+	aoc::Position parsePos(std::string_view line) const
 	{
-		std::regex xNumRegex(R"(X[\+-=]\d{1,})");
-		std::regex yNumRegex(R"(Y[\+-=]\d{1,})");
-		std::smatch xMatch;
-		std::smatch yMatch;
-		std::regex_search(line, xMatch, xNumRegex);
-		std::regex_search(line, yMatch, yNumRegex);
-		std::string matchX = xMatch.str().substr(1);
-		std::string matchY = yMatch.str().substr(1);
-		if (matchX.front() == '=') {
-			matchX = matchX.substr(1);
+		return {parseCoordinate(line, 'X'), parseCoordinate(line, 'Y')};
+	}
+
+	// Handles both "X+94" of buttons and "X=8400" of prizes
+	int64_t parseCoordinate(std::string_view line, char axis) const
+	{
+		size_t axisPos = line.find(axis);
+		if (axisPos == std::string_view::npos) {
+			throw std::invalid_argument("Missing " + std::string(1, axis) + " coordinate in: " + std::string(line));
 		}
-		if (matchY.front() == '=') {
-			matchY = matchY.substr(1);
+
+		aoc::Scanner scanner{ line.substr(axisPos + 1) };
+		if (!scanner.skip('=')) {
+			scanner.skip('+');
 		}
-		return {std::stoi(matchX), std::stoi(matchY)};
+		return scanner.nextInt<int64_t>();
 	}
 };
 
@@ -112,10 +127,60 @@ public:
 	}
 };
 
+class Day13Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_machines = ClawMachineParser().parseClawMachines(input.lines());
+	}
+
+	// Only the far away prizes are solved here
+	std::string part1() override
+	{
+		return {};
+	}
 
+	std::string part2() override
+	{
+		PrizeFinder finder;
+		uint64_t sum{};
+		for (const auto& machine : m_machines) {
+			uint64_t result = finder.getMinimumPrizeCost(machine);
+			if (result != UINT64_MAX) {
+				sum += result;
+			}
+		}
+		return std::to_string(sum);
+	}
+
+private:
+	std::vector<ClawMachine> m_machines;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day13Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day13;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runArgs, "--stream");
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "example.txt";
@@ -123,21 +188,39 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	ClawMachineParser parser;
-	PrizeFinder finder;
-	for (const std::string& arg : runArgs) {
-		std::vector<std::string> lines{ aoc::loadFile(arg) };
-		auto machines = parser.parseClawMachines(lines);
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		ClawMachineParser parser;
+		PrizeFinder finder;
+		if (streaming) {
+			// Machines are solved one by one as their records are read
+			aoc::ScopedPhase streamPhase("stream");
+			aoc::StreamReader reader(arg);
+			uint64_t sum{};
+			reader.forEachRecord([&](std::string_view record) {
+				uint64_t result = finder.getMinimumPrizeCost(parser.parseClawMachine(record));
+				out << result << '\n';
+				if (result != UINT64_MAX) {
+					sum += result;
+				}
+			});
+			out << "Result sum = " << sum << '\n';
+			return;
+		}
+
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto machines = aoc::profile("parse", [&] { return parser.parseClawMachines(input.lines()); });
+		aoc::ScopedPhase solvePhase("part2");
 		uint64_t sum{};
 		for (auto& machine : machines) {
 			uint64_t result = finder.getMinimumPrizeCost(machine);
-			std::cout << result << std::endl;
+			out << result << '\n';
 			if (result != UINT64_MAX) {
 				sum += result;
 			}
 		}
-		std::cout << "Result sum = " << sum << std::endl;
-	}
+		out << "Result sum = " << sum << '\n';
+	});
 
 	return 0;
 }
+#endif
@@ -1,7 +1,11 @@
 ﻿#include <utils.hpp>
-#include <regex>
+#include <Solver.hpp>
+#include <Batch.hpp>
 #include <queue>
 #include <algorithm>
+#include <cmath>
+
+namespace day14 {
 
 // horrible code
 
@@ -19,17 +23,17 @@ struct Robot
 class RobotParser
 {
 public:
-	std::vector<Robot> parseRobots(const std::vector<std::string>& lines)
+	std::vector<Robot> parseRobots(const aoc::MappedInput& lines)
 	{
 		std::vector<Robot> robots;
-		for (const std::string& line : lines) {
+		for (std::string_view line : lines) {
 			Robot r = parseRobot(line);
 			robots.push_back(r);
 		}
 		return robots;
 	}
 
-	Robot parseRobot(const std::string& line)
+	Robot parseRobot(std::string_view line)
 	{
 		aoc::Position pos = parsePosition(line);
 		aoc::Vec2D vec = parseVec2D(line);
@@ -37,24 +41,29 @@ public:
 	}
 
 private:
-	aoc::Position parsePosition(const std::string& line)
+	aoc::Position parsePosition(std::string_view line)
 	{
-		std::regex posRegex(R"(p=(-?\d+),(-?\d+))");
-		std::smatch match;
-		if (std::regex_search(line, match, posRegex) && match.size() == 3) {
-			return {std::stoll(match[1].str()), std::stoll(match[2].str())};
-		}
-		return {};
+		auto [x, y] = parsePair(line, "p=");
+		return {x, y};
+	}
+
+	aoc::Vec2D parseVec2D(std::string_view line)
+	{
+		auto [x, y] = parsePair(line, "v=");
+		return {x, y};
 	}
 
-	aoc::Vec2D parseVec2D(const std::string& line)
+	std::pair<int64_t, int64_t> parsePair(std::string_view line, std::string_view prefix)
 	{
-		std::regex velRegex(R"(v=(-?\d+),(-?\d+))");
-		std::smatch match;
-		if (std::regex_search(line, match, velRegex) && match.size() == 3) {
-			return {std::stoll(match[1].str()), std::stoll(match[2].str())};
+		size_t prefixPos = line.find(prefix);
+		if (prefixPos == std::string_view::npos) {
+			return {};
 		}
-		return {};
+
+		aoc::Scanner scanner{ line.substr(prefixPos + prefix.size()) };
+		int64_t x = scanner.nextInt<int64_t>();
+		scanner.expect(',');
+		return {x, scanner.nextInt<int64_t>()};
 	}
 };
 
@@ -100,15 +109,15 @@ public:
 		return robots;
 	}
 
-	void display() const 
+	void display(std::ostream& out) const 
 	{
 		for (int64_t y = 0; y < m_sizeY; ++y) {
 			for (int64_t x = 0; x < m_sizeX; ++x) {
-				std::cout << ((countRobotsOn({ x,y }) != 0) ? "R " : "  ");
+				out << ((countRobotsOn({ x,y }) != 0) ? "R " : "  ");
 			}
-			std::cout << std::endl;
+			out << '\n';
 		}
-		std::cout << std::endl;
+		out << '\n';
 	}
 
 	double robotsStdPosY() const
@@ -236,10 +245,55 @@ public:
 	}
 };
 
+class Day14Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_robots = RobotParser().parseRobots(input);
+	}
+
+	std::string part1() override
+	{
+		Restroom restroom(m_sizeX, m_sizeY, m_robots);
+		return std::to_string(RobotsSolution().getSafetyFactor(restroom, 100));
+	}
+
+	std::string part2() override
+	{
+		Restroom restroom(m_sizeX, m_sizeY, m_robots);
+		auto sortedResults = RobotsSolution().dtWithLeastStdProduct(restroom, 10000);
+		return std::to_string(sortedResults.front().first);
+	}
 
+private:
+	static constexpr int64_t m_sizeX = 101;
+	static constexpr int64_t m_sizeY = 103;
+	std::vector<Robot> m_robots;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day14Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day14;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "example.txt";
@@ -247,31 +301,27 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	RobotParser parser;
-	RobotsSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			std::vector<std::string> lines{ aoc::loadFile(arg) };
-			auto robots = parser.parseRobots(lines);
-			Restroom restroom (101, 103, robots);
-			uint64_t dt = 100;
-			std::cout << "Safety factor after " << dt << " s: "
-				<< solution.getSafetyFactor(restroom, 100)
-				<< std::endl;
-
-			auto sortedResults = solution.dtWithLeastStdProduct(restroom, 10000);
-			std::cout << "Element with christmas tree (smallest std): "
-				<< sortedResults.front().first
-				<< std::endl;
-
-			Restroom room(restroom);
-			room.moveAllRobots(sortedResults.front().first);
-			room.display();
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		RobotParser parser;
+		RobotsSolution solution;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto robots = aoc::profile("parse", [&] { return parser.parseRobots(input); });
+		Restroom restroom (101, 103, robots);
+		uint64_t dt = 100;
+		out << "Safety factor after " << dt << " s: "
+			<< aoc::profile("part1", [&] { return solution.getSafetyFactor(restroom, 100); })
+			<< '\n';
+
+		auto sortedResults = aoc::profile("part2", [&] { return solution.dtWithLeastStdProduct(restroom, 10000); });
+		out << "Element with christmas tree (smallest std): "
+			<< sortedResults.front().first
+			<< '\n';
+
+		Restroom room(restroom);
+		room.moveAllRobots(sortedResults.front().first);
+		room.display(out);
+	});
 
 	return 0;
 }
+#endif
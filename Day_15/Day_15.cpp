@@ -1,5 +1,12 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <Grid.hpp>
+#include <FlatHash.hpp>
 #include <memory>
+#include <optional>
+
+namespace day15 {
 
 // ugh, solution straight from nightmare
 
@@ -34,41 +41,41 @@ class BoxR : public Box
 class Warehouse
 {
 public:
-	Warehouse(std::vector<std::vector<std::shared_ptr<BoardElement>>>&& tiles, aoc::Position robotPos)
+	using Tiles = aoc::Grid<std::shared_ptr<BoardElement>>;
+
+	Warehouse(Tiles&& tiles, aoc::Position robotPos)
 		: m_board{ std::move(tiles) }, m_robotPos(robotPos)
 	{}
 
 	size_t sizeX() const {
-		return m_board[0].size();
+		return m_board.sizeX();
 	}
 
 	size_t sizeY() const {
-		return m_board.size();
+		return m_board.sizeY();
 	}
 
 	bool contains(const aoc::Position& p) const {
-		return p.x >= 0 && static_cast<size_t>(p.x) < sizeX() 
-			&& p.y >= 0 && static_cast<size_t>(p.y) < sizeY();
+		return m_board.contains(p);
 	}
 
 	std::shared_ptr<BoardElement>& at(const aoc::Position& p) {
-		return m_board[p.y][p.x];
+		return m_board.at(p);
 	}
 
 	const std::shared_ptr<BoardElement>& at(const aoc::Position& p) const {
-		return m_board[p.y][p.x];
+		return m_board.at(p);
 	}
 
 	void display() const {
-		for (int y = 0; y < sizeY(); ++y) {
-			const auto& row = m_board[y];
-			for (int x = 0; x < sizeX(); ++x) {
+		for (int64_t y = 0; y < (int64_t)sizeY(); ++y) {
+			for (int64_t x = 0; x < (int64_t)sizeX(); ++x) {
 				if (aoc::Position{ x,y } == m_robotPos) {
 					std::cout << "@ ";
 					continue;
 				}
 
-				const auto& element = row[x];
+				const auto& element = m_board.at({ x,y });
 				if (element) {
 					if (!element->isMovable()) {
 						std::cout << "# ";
@@ -158,7 +165,7 @@ private:
 		}
 	}
 
-	void moveWithPush(aoc::Position pos, aoc::Vec2D v, std::unordered_set<aoc::Position> visited = {})
+	void moveWithPush(aoc::Position pos, aoc::Vec2D v, aoc::FlatSet<aoc::Position> visited = {})
 	{
 		if (visited.contains(pos)) {
 			return;
@@ -185,74 +192,77 @@ private:
 	}
 
 	aoc::Position m_robotPos;
-	std::vector<std::vector<std::shared_ptr<BoardElement>>> m_board;
+	Tiles m_board;
 };
 
 
 class WarehouseParser
 {
 public:
-	Warehouse parseWarehouse(const std::vector<std::string>& lines)
+	Warehouse parseWarehouse(const std::vector<std::string_view>& lines)
 	{
-		std::vector<std::vector<std::shared_ptr<BoardElement>>> parsedTiles;
+		if (lines.empty()) {
+			throw std::invalid_argument("Warehouse is empty!");
+		}
+
+		Warehouse::Tiles parsedTiles(lines.front().size(), lines.size());
 		aoc::Position robotInitPos{};
 
-		for (int y = 0; y < lines.size(); y++) {
-			const std::string& line = lines[y];
+		for (int64_t y = 0; y < (int64_t)lines.size(); y++) {
+			std::string_view line = lines[y];
+			if (line.size() != parsedTiles.sizeX()) {
+				throw std::invalid_argument("Warehouse is not rectangular!");
+			}
 
-			std::vector<std::shared_ptr<BoardElement>> parsedRow;
-			for (int x = 0; x < line.size(); x++) {
+			for (int64_t x = 0; x < (int64_t)line.size(); x++) {
 				char c = line[x];
-				std::shared_ptr<BoardElement> parsedElement = nullptr;
+				auto& parsedElement = parsedTiles.at({ x, y });
 				if (c == wall) parsedElement = std::make_shared<Wall>();
 				else if (c == box) parsedElement = std::make_shared<Box>();
 				else if (c == robot) robotInitPos = { x, y };
-				parsedRow.push_back(parsedElement);
 			}
-
-			parsedTiles.push_back(std::move(parsedRow));
 		}
 
 		return Warehouse{ std::move(parsedTiles), robotInitPos };
 	}
 
-	Warehouse parseWideWarehouse(const std::vector<std::string>& lines)
+	Warehouse parseWideWarehouse(const std::vector<std::string_view>& lines)
 	{
-		std::vector<std::vector<std::shared_ptr<BoardElement>>> parsedTiles;
+		if (lines.empty()) {
+			throw std::invalid_argument("Warehouse is empty!");
+		}
+
+		Warehouse::Tiles parsedTiles(2 * lines.front().size(), lines.size());
 		aoc::Position robotInitPos{};
 
-		for (int y = 0; y < lines.size(); y++) {
-			const std::string& line = lines[y];
+		for (int64_t y = 0; y < (int64_t)lines.size(); y++) {
+			std::string_view line = lines[y];
+			if (2 * line.size() != parsedTiles.sizeX()) {
+				throw std::invalid_argument("Warehouse is not rectangular!");
+			}
 
-			std::vector<std::shared_ptr<BoardElement>> parsedRow;
-			for (int x = 0; x < line.size(); x++) {
+			for (int64_t x = 0; x < (int64_t)line.size(); x++) {
 				char c = line[x];
+				aoc::Position left{ 2 * x, y };
+				aoc::Position right{ 2 * x + 1, y };
 				if (c == wall) {
-					parsedRow.push_back(std::make_shared<Wall>());
-					parsedRow.push_back(std::make_shared<Wall>());
+					parsedTiles.at(left) = std::make_shared<Wall>();
+					parsedTiles.at(right) = std::make_shared<Wall>();
 				}
 				else if (c == box) {
-					parsedRow.push_back(std::make_shared<BoxL>());
-					parsedRow.push_back(std::make_shared<BoxR>());
+					parsedTiles.at(left) = std::make_shared<BoxL>();
+					parsedTiles.at(right) = std::make_shared<BoxR>();
 				}
-				else {
-					if (c == robot) {
-						int64_t robotX = static_cast<int64_t>(parsedRow.size());
-						int64_t robotY = y;
-						robotInitPos = { robotX, robotY };
-					}
-					parsedRow.push_back(nullptr);
-					parsedRow.push_back(nullptr);
+				else if (c == robot) {
+					robotInitPos = left;
 				}
 			}
-
-			parsedTiles.push_back(std::move(parsedRow));
 		}
 
 		return Warehouse{ std::move(parsedTiles), robotInitPos };
 	}
 
-	std::vector<aoc::Vec2D> parseMoves(const std::string& line)
+	std::vector<aoc::Vec2D> parseMoves(std::string_view line)
 	{
 		std::vector<aoc::Vec2D> result;
 		for (auto c : line) {
@@ -269,10 +279,10 @@ public:
 		return result;
 	}
 
-	auto splitData(const std::vector<std::string>& lines)
-		-> std::pair<std::vector<std::string>, std::string>
+	auto splitData(const std::vector<std::string_view>& lines)
+		-> std::pair<std::vector<std::string_view>, std::string_view>
 	{
-		std::pair<std::vector<std::string>, std::string> result;
+		std::pair<std::vector<std::string_view>, std::string_view> result;
 		for (auto& line : lines) {
 			if (line.empty()) {
 				break;
@@ -280,13 +290,13 @@ public:
 			result.first.push_back(line);
 		}
 
-		const std::string& lastLine = lines.back();
-		size_t firstNotOf = lastLine.find_first_not_of({ up,left,down,right });
-		if (firstNotOf == std::string::npos) {
+		std::string_view lastLine = lines.back();
+		size_t firstNotOf = lastLine.find_first_not_of(std::string{ up,left,down,right });
+		if (firstNotOf == std::string_view::npos) {
 			result.second = lastLine;
 		}
 		else {
-			throw std::exception("Incorrect move data format!");
+			throw std::invalid_argument("Incorrect move data format!");
 		}
 
 		return result;
@@ -303,9 +313,62 @@ private:
 	static constexpr char robot = '@';
 };
 
+class Day15Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		std::vector<std::string_view> lines{ input.lines() };
+		WarehouseParser parser;
+		auto [warehouseLines, movesLines] = parser.splitData(lines);
+		m_warehouse.emplace(parser.parseWarehouse(warehouseLines));
+		m_wideWarehouse.emplace(parser.parseWideWarehouse(warehouseLines));
+		m_moves = parser.parseMoves(movesLines);
+	}
+
+	// Tiles hold stateless elements, so a copy of the warehouse can be moved around freely
+	std::string part1() override
+	{
+		Warehouse warehouse = m_warehouse.value();
+		warehouse.performMoves(m_moves);
+		return std::to_string(warehouse.sumOfCoordinatesGPS());
+	}
+
+	std::string part2() override
+	{
+		Warehouse wideWarehouse = m_wideWarehouse.value();
+		wideWarehouse.performMoves(m_moves);
+		return std::to_string(wideWarehouse.sumOfCoordinatesGPS());
+	}
+
+private:
+	std::optional<Warehouse> m_warehouse;
+	std::optional<Warehouse> m_wideWarehouse;
+	std::vector<aoc::Vec2D> m_moves;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day15Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day15;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "picoExample.txt";
@@ -313,29 +376,32 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	WarehouseParser parser;
-	for (const std::string& arg : runArgs) {
-		try {
-			// load data from file
-			std::vector<std::string> lines{ aoc::loadFile(arg) };
-			auto [warehouseLines, movesLines] = parser.splitData(lines);
-			auto warehouse = parser.parseWarehouse(warehouseLines);
-			auto moves = parser.parseMoves(movesLines);
-
-			// GPS coords for normal warehouse
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		WarehouseParser parser;
+		// load data from file
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		std::vector<std::string_view> lines{ input.lines() };
+		auto [warehouseLines, movesLines] = parser.splitData(lines);
+		auto warehouse = aoc::profile("parse", [&] { return parser.parseWarehouse(warehouseLines); });
+		auto moves = aoc::profile("parse", [&] { return parser.parseMoves(movesLines); });
+
+		// GPS coords for normal warehouse
+		auto gpsSum = aoc::profile("part1", [&] {
 			warehouse.performMoves(moves);
-			std::cout << "Sum of GPS coord: " << warehouse.sumOfCoordinatesGPS() << std::endl;
+			return warehouse.sumOfCoordinatesGPS();
+		});
+		out << "Sum of GPS coord: " << gpsSum << '\n';
 
-			// GPS coords for wide warehouse
+		// GPS coords for wide warehouse
+		auto wideGpsSum = aoc::profile("part2", [&] {
 			auto wideWarehouse = parser.parseWideWarehouse(warehouseLines);
 			wideWarehouse.performMoves(moves);
-			std::cout << "Sum of GPS coord for wide boxes: " 
-				<< wideWarehouse.sumOfCoordinatesGPS() << std::endl;
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+			return wideWarehouse.sumOfCoordinatesGPS();
+		});
+		out << "Sum of GPS coord for wide boxes: " 
+			<< wideGpsSum << '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,8 +1,16 @@
 ﻿#include <utils.hpp>
-#include <unordered_map>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <FlatHash.hpp>
+#include <CsrGraph.hpp>
+#include <Arena.hpp>
 #include <array>
 #include <algorithm>
+#include <deque>
 #include <queue>
+#include <optional>
+
+namespace day16 {
 
 enum class Dir
 {
@@ -73,25 +81,27 @@ struct Node
 	}
 };
 
+}
+
 template<>
-struct std::hash<Node> {
-	std::size_t operator()(const Node& n) const {
-		return std::hash<aoc::Position>{}(n.pos) ^
-			std::hash<int>{}(static_cast<int>(n.dir)) << 1;
+struct std::hash<day16::Node> {
+	std::size_t operator()(const day16::Node& n) const {
+		return aoc::combineHash(std::hash<aoc::Position>{}(n.pos), static_cast<uint64_t>(n.dir));
 	}
 };
 
+namespace day16 {
+
+// Nodes are the junctions and corners of the maze in every direction, the
+// graph's vertices are their ids in m_nodes
 class Maze
 {
 public:
-	using Graph = std::unordered_map<Node, std::unordered_map<Node, uint64_t>>;
+	using Graph = aoc::CsrGraph<uint64_t>;
+	using Nodes = aoc::LabelInterner<Node>;
 
-	Maze(const Graph& g)
-		: m_graph(g)
-	{}
-
-	Maze(Graph&& g)
-		: m_graph(std::move(g))
+	Maze(Graph graph, Nodes nodes)
+		: m_graph(std::move(graph)), m_reversedGraph(m_graph.transposed()), m_nodes(std::move(nodes))
 	{}
 
 	const Graph& getGraph() const
@@ -99,8 +109,21 @@ public:
 		return m_graph;
 	}
 
+	// Edges lead to the nodes they came from, for walking paths backwards
+	const Graph& getReversedGraph() const
+	{
+		return m_reversedGraph;
+	}
+
+	const Nodes& getNodes() const
+	{
+		return m_nodes;
+	}
+
 private:
 	Graph m_graph;
+	Graph m_reversedGraph;
+	Nodes m_nodes;
 };
 
 
@@ -108,46 +131,54 @@ private:
 class MazeParser
 {
 public:
-	auto parseMaze(const std::vector<std::string>& lines) const
+	auto parseMaze(const std::vector<std::string_view>& lines) const
 		-> Maze
 	{
 		if (!isCorrectFormat(lines)) {
 			throw std::invalid_argument("Invalid labirynth format!");
 		}
 
-		Maze::Graph graph;
+		Maze::Nodes nodes;
 		for (int y = 1; y < lines.size() - 1; ++y) {
 			for (int x = 1; x < lines[y].size() - 1; ++x) {
 				aoc::Position pos{ x,y };
 				if (isNode(lines, pos)) {
-					auto posNodes = generateNodesWithTurnEdges(pos);
-					graph.insert(posNodes.begin(), posNodes.end());
+					for (Dir dir : getAllDirs()) {
+						nodes.intern({ pos, dir });
+					}
 				}
 			}
 		}
 
-		for (auto& [node, edges] : graph) {
-			auto edge = generateNeigbourEdge(lines, node);
-			if (edge.first != errorNode) {
-				edges.insert(edge);
+		std::vector<Maze::Graph::Edge> edges;
+		for (aoc::Vertex v = 0; v < nodes.size(); ++v) {
+			const Node& node = nodes.label(v);
+			for (Dir dir : getTurnDirs(node.dir)) {
+				edges.push_back({ v, nodes.at({ node.pos, dir }), turnCost });
+			}
+
+			auto [next, cost] = generateNeigbourEdge(lines, node);
+			if (next != errorNode) {
+				edges.push_back({ v, nodes.at(next), cost });
 			}
 		}
 
-		return { std::move(graph) };
+		Maze::Graph graph(nodes.size(), edges);
+		return { std::move(graph), std::move(nodes) };
 	}
 
-	aoc::Position findStart(const std::vector<std::string>& lines) const
+	aoc::Position findStart(const std::vector<std::string_view>& lines) const
 	{
 		return findFirst(startField, lines);
 	}
 
-	aoc::Position findEnd(const std::vector<std::string>& lines) const
+	aoc::Position findEnd(const std::vector<std::string_view>& lines) const
 	{
 		return findFirst(endField, lines);
 	}
 
 private:
-	auto generateNeigbourEdge(const std::vector<std::string>& map, const Node& n) const
+	auto generateNeigbourEdge(const std::vector<std::string_view>& map, const Node& n) const
 		-> std::pair<Node, uint64_t>
 	{
 		aoc::Vec2D dirVec = getDirVector(n.dir);
@@ -165,42 +196,19 @@ private:
 		return { errorNode, UINT64_MAX };
 	}
 
-	auto generateNodesWithTurnEdges(const aoc::Position& pos) const
-		-> std::unordered_map<Node, std::unordered_map<Node, uint64_t>>
+	std::vector<Dir> getTurnDirs(Dir dir) const
 	{
-		std::unordered_map<Node, std::unordered_map<Node, uint64_t>> result;
-		for (const Node& node : generateNodes(pos)) {
-			auto nodeEdges = generateTurnEdges(node);
-			result[node].insert(nodeEdges.begin(), nodeEdges.end());
-		}
-
-		return result;
-	}
-
-	std::unordered_map<Node, uint64_t> generateTurnEdges(const Node& n) const
-	{
-		std::unordered_map<Node, uint64_t> edges;
-		std::array<Dir, 4> dirs = getAllDirs();
-		for (Dir dir : dirs) {
-			if (dir != n.dir && dir != getOppositeDir(n.dir)) {
-				edges.insert({ Node{n.pos,dir}, turnCost });
+		std::vector<Dir> turns;
+		for (Dir turn : getAllDirs()) {
+			if (turn != dir && turn != getOppositeDir(dir)) {
+				turns.push_back(turn);
 			}
 		}
 
-		return edges;
+		return turns;
 	}
 
-	std::unordered_set<Node> generateNodes(const aoc::Position& p) const
-	{
-		std::unordered_set<Node> nodes;
-		std::array<Dir, 4> dirs = getAllDirs();
-		for (Dir dir : dirs) {
-			nodes.insert(Node{ p, dir });
-		}
-		return nodes;
-	}
-
-	bool isCorrectFormat(const std::vector<std::string>& map) const
+	bool isCorrectFormat(const std::vector<std::string_view>& map) const
 	{
 		static constexpr size_t MIN_SIZE_Y = 4;
 		static constexpr size_t MIN_SIZE_X = 4;
@@ -229,7 +237,7 @@ private:
 		return true;
 	}
 
-	aoc::Position findFirst(char searchedChar, const std::vector<std::string>& lines) const
+	aoc::Position findFirst(char searchedChar, const std::vector<std::string_view>& lines) const
 	{
 		for (int y = 0; y < (int)lines.size(); ++y) {
 			for (int x = 0; x < (int)lines[y].size(); ++x) {
@@ -241,7 +249,7 @@ private:
 		return errorPos;
 	}
 
-	bool isNode(const std::vector<std::string>& map, const aoc::Position& p) const
+	bool isNode(const std::vector<std::string_view>& map, const aoc::Position& p) const
 	{
 		bool visitable = canVisit(map, p);
 		uint8_t availablePaths = countAvailablePaths(map, p);
@@ -250,13 +258,13 @@ private:
 			(countAvailablePaths(map, p) != 2 || !isStraightPath(map, p));
 	}
 
-	bool isStraightPath(const std::vector<std::string>& map, const aoc::Position& p) const
+	bool isStraightPath(const std::vector<std::string_view>& map, const aoc::Position& p) const
 	{
 		return canVisit(map[p.y][p.x + 1]) == canVisit(map[p.y][p.x - 1]) &&
 			canVisit(map[p.y - 1][p.x]) == canVisit(map[p.y + 1][p.x]);
 	}
 
-	uint8_t countAvailablePaths(const std::vector<std::string>& map, const aoc::Position& p) const
+	uint8_t countAvailablePaths(const std::vector<std::string_view>& map, const aoc::Position& p) const
 	{
 		auto dirs = getAllDirs();
 		uint8_t pathsCount{};
@@ -270,12 +278,12 @@ private:
 		return pathsCount;
 	}
 
-	bool mapContains(const std::vector<std::string>& map, const aoc::Position& p) const
+	bool mapContains(const std::vector<std::string_view>& map, const aoc::Position& p) const
 	{
 		return p.y >= 0 && p.y < (int)map.size() && p.x >= 0 && p.x < (int)map.at(p.y).size();
 	}
 
-	bool canVisit(const std::vector<std::string>& map, const aoc::Position& p) const
+	bool canVisit(const std::vector<std::string_view>& map, const aoc::Position& p) const
 	{
 		return canVisit(map[p.y][p.x]);
 	}
@@ -300,146 +308,194 @@ private:
 class MazeSolution
 {
 public:
-	using DistancesMap = std::unordered_map<Node, std::pair<uint64_t, std::vector<Node>>>;
+	// Distance of every vertex of the maze's graph, UINT64_MAX when unreachable
+	using Distances = std::pmr::vector<uint64_t>;
+
+	// Distances, paths and tiles are allocated from memory
+	explicit MazeSolution(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+		: m_memory{ memory }
+	{}
 
 	uint64_t findMinScore(const Maze& maze, aoc::Position startPos, Dir startDir, aoc::Position endPos) const
 	{
-		DistancesMap distances = getMinimalDistances(maze.getGraph(), {startPos, startDir});
-		return minDistanceToField(distances, endPos);
+		Distances distances = getMinimalDistances(maze, {startPos, startDir});
+		return minDistanceToField(maze, distances, endPos);
 	}
 
-	uint64_t findMinScore(const DistancesMap& distances, aoc::Position endPos) const
+	uint64_t findMinScore(const Maze& maze, const Distances& distances, aoc::Position endPos) const
 	{
-		return minDistanceToField(distances, endPos);
+		return minDistanceToField(maze, distances, endPos);
 	}
 
-	auto getUniqueMinPathTiles(const DistancesMap& distances, const aoc::Position& endPos) const
-		-> std::unordered_set<aoc::Position>
+	// Walks the minimal paths back from the end, a node is on one when
+	// reaching it through an edge costs exactly its distance
+	auto getUniqueMinPathTiles(const Maze& maze, const Distances& distances, const aoc::Position& endPos) const
+		-> aoc::pmr::FlatSet<aoc::Position>
 	{
-		uint64_t minDist = findMinScore(distances, endPos);
-		std::queue<Node> nodesQueue;
+		const Maze::Nodes& nodes = maze.getNodes();
+		const Maze::Graph& reversed = maze.getReversedGraph();
+		uint64_t minDist = findMinScore(maze, distances, endPos);
+		std::queue<aoc::Vertex, std::pmr::deque<aoc::Vertex>> nodesQueue{ std::pmr::deque<aoc::Vertex>(m_memory) };
 		for (const auto& dir : getAllDirs()) {
-			Node node{ endPos, dir };
-			if (distances.at(node).first == minDist) {
+			aoc::Vertex node = nodes.at({ endPos, dir });
+			if (distances[node] == minDist) {
 				nodesQueue.push(node);
 			}
 		}
 
-		std::unordered_set<Node> visitedNodes;
-		std::unordered_set<aoc::Position> tiles;
+		std::pmr::vector<bool> visitedNodes(nodes.size(), false, m_memory);
+		aoc::pmr::FlatSet<aoc::Position> tiles(m_memory);
 		while (!nodesQueue.empty()) {
-			Node n = nodesQueue.front();
+			aoc::Vertex n = nodesQueue.front();
 			nodesQueue.pop();
 
-			if (visitedNodes.contains(n)) {
+			if (visitedNodes[n]) {
 				continue;
 			}
 
-			auto& neighbours = distances.at(n).second;
-			for (auto& neighbour : neighbours) {
-				nodesQueue.push(neighbour);
-				auto t = getTilesBetween(n, neighbour);
-				tiles.insert(t.begin(), t.end());
+			auto previous = reversed.targets(n);
+			auto costs = reversed.weights(n);
+			for (size_t i = 0; i < previous.size(); ++i) {
+				aoc::Vertex neighbour = previous[i];
+				if (distances[neighbour] != UINT64_MAX && distances[neighbour] + costs[i] == distances[n]) {
+					nodesQueue.push(neighbour);
+					addTilesBetween(nodes.label(n), nodes.label(neighbour), tiles);
+				}
 			}
-			visitedNodes.insert(n);
+			visitedNodes[n] = true;
 		}
 
 		return tiles;
 	}
 
-	DistancesMap getMinimalDistances(const Maze::Graph& graph, const Node& from) const
+	Distances getMinimalDistances(const Maze& maze, const Node& from) const
 	{
-		if (!graph.contains(from)) {
+		std::optional<aoc::Vertex> start = maze.getNodes().find(from);
+		if (!start) {
 			throw std::invalid_argument("Graph doesn't contain start node");
 		}
 
-		std::unordered_set<Node> visitedNodes;
-		DistancesMap distances = getDistancesMap(graph, from);
-
-		auto cmp = [&distances](const Node& a, const Node& b) {
-			return distances[a].first > distances[b].first;
-			};
-		std::priority_queue<Node, std::vector<Node>, decltype(cmp)> pq(cmp);
+		const Maze::Graph& graph = maze.getGraph();
+		Distances distances(graph.vertexCount(), UINT64_MAX, m_memory);
+		using QueueEntry = std::pair<uint64_t, aoc::Vertex>;
+		std::priority_queue<QueueEntry, std::pmr::vector<QueueEntry>, std::greater<QueueEntry>> pq{
+			std::greater<QueueEntry>{}, std::pmr::vector<QueueEntry>(m_memory) };
 
-
-		pq.push(from);
+		distances[*start] = 0;
+		pq.push({ 0, *start });
 		while (!pq.empty()) {
-			Node currNode = pq.top();
+			auto [dist, currNode] = pq.top();
 			pq.pop();
-			for (const auto& [node, dist] : graph.at(currNode)) {
-				if (visitedNodes.contains(node)) {
-					continue;
-				}
-
-				uint64_t newDist = distances[currNode].first + dist;
-				if (newDist < distances[node].first) {
-					distances[node].first = newDist;
-					distances[node].second.clear();
-					pq.push(node);
-				}
+			// Stale entry of a node reached cheaper later
+			if (dist != distances[currNode]) {
+				continue;
+			}
 
-				if (newDist <= distances[node].first) {
-					distances[node].second.push_back(currNode);
+			auto targets = graph.targets(currNode);
+			auto costs = graph.weights(currNode);
+			for (size_t i = 0; i < targets.size(); ++i) {
+				uint64_t newDist = dist + costs[i];
+				if (newDist < distances[targets[i]]) {
+					distances[targets[i]] = newDist;
+					pq.push({ newDist, targets[i] });
 				}
 			}
-			visitedNodes.insert(currNode);
 		}
 
 		return distances;
 	}
 
 private:
-	auto getTilesBetween(const Node& a, const Node& b) const
-		-> std::unordered_set<aoc::Position>
+	void addTilesBetween(const Node& a, const Node& b, aoc::pmr::FlatSet<aoc::Position>& tiles) const
 	{
-		std::unordered_set<aoc::Position> result;
-		
 		auto [xMin, xMax] = std::minmax(a.pos.x, b.pos.x);
 		auto [yMin, yMax] = std::minmax(a.pos.y, b.pos.y);
 
 		if (yMin == yMax) {
 			for (int64_t i = xMin; i <= xMax; i++) {
-				result.emplace(i, yMin);
+				tiles.emplace(i, yMin);
 			}
 		}
 		else if (xMin == xMax) {
 			for (int64_t i = yMin; i <= yMax; i++) {
-				result.emplace(xMin, i);
+				tiles.emplace(xMin, i);
 			}
 		}
 		else {
 			throw std::runtime_error("Nodes are not in straight line.");
 		}
-
-		return result;
 	}
 
-	auto getDistancesMap(const Maze::Graph& graph, const Node& startNode) const
-		-> DistancesMap
-	{
-		DistancesMap distances;
-		for (auto& [node, edges] : graph) {
-			distances[node] = { UINT64_MAX, {} };
-		}
-		distances[startNode] = { 0ull, {} };
-		
-		return distances;
-	}
-
-	uint64_t minDistanceToField(const DistancesMap& dist, const aoc::Position& p) const
+	uint64_t minDistanceToField(const Maze& maze, const Distances& dist, const aoc::Position& p) const
 	{
 		uint64_t minDistToField = UINT64_MAX;
 		for (const auto& dir : getAllDirs()) {
-			Node fieldNode{ p, dir };
-			minDistToField = std::min(dist.at(fieldNode).first, minDistToField);
+			aoc::Vertex fieldNode = maze.getNodes().at({ p, dir });
+			minDistToField = std::min(dist[fieldNode], minDistToField);
 		}
 		return minDistToField;
 	}
+
+	std::pmr::memory_resource* m_memory;
 };
 
+class Day16Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		auto lines = input.lines();
+		MazeParser parser;
+		m_maze.emplace(parser.parseMaze(lines));
+		m_startPos = parser.findStart(lines);
+		m_endPos = parser.findEnd(lines);
+	}
+
+	std::string part1() override
+	{
+		m_arena.reset();
+		MazeSolution solution(&m_arena);
+		auto distances = solution.getMinimalDistances(*m_maze, { m_startPos, Dir::EAST });
+		return std::to_string(solution.findMinScore(*m_maze, distances, m_endPos));
+	}
+
+	std::string part2() override
+	{
+		m_arena.reset();
+		MazeSolution solution(&m_arena);
+		auto distances = solution.getMinimalDistances(*m_maze, { m_startPos, Dir::EAST });
+		return std::to_string(solution.getUniqueMinPathTiles(*m_maze, distances, m_endPos).size());
+	}
+
+private:
+	std::optional<Maze> m_maze;
+	aoc::Position m_startPos;
+	aoc::Position m_endPos;
+	aoc::Arena m_arena;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day16Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day16;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "p2Example.txt";
@@ -449,26 +505,23 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	MazeParser parser;
-	MazeSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			auto lines = aoc::loadFile(arg);
-			Maze maze = parser.parseMaze(lines);
-			aoc::Position startPos = parser.findStart(lines);
-			aoc::Position endPos = parser.findEnd(lines);
-			Node startNode{ startPos, Dir::EAST };
-			auto distMap = solution.getMinimalDistances(maze.getGraph(), startNode);
-			std::cout << "Minimal score: "
-				<< solution.findMinScore(distMap, endPos)
-				<< std::endl
-				<< "Unique tiles in minimal paths:"
-				<< solution.getUniqueMinPathTiles(distMap, endPos).size();
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out, aoc::Arena& arena) {
+		MazeParser parser;
+		MazeSolution solution(&arena);
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		Maze maze = aoc::profile("parse", [&] { return parser.parseMaze(lines); });
+		aoc::Position startPos = parser.findStart(lines);
+		aoc::Position endPos = parser.findEnd(lines);
+		Node startNode{ startPos, Dir::EAST };
+		auto distances = aoc::profile("part1", [&] { return solution.getMinimalDistances(maze, startNode); });
+		out << "Minimal score: "
+			<< solution.findMinScore(maze, distances, endPos)
+			<< '\n'
+			<< "Unique tiles in minimal paths:"
+			<< aoc::profile("part2", [&] { return solution.getUniqueMinPathTiles(maze, distances, endPos).size(); });
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,9 +1,13 @@
 ﻿#include <utils.hpp>
-#include <regex>
+#include <Solver.hpp>
+#include <Batch.hpp>
 #include <unordered_map>
 #include <functional>
 #include <queue>
 #include <deque>
+#include <optional>
+
+namespace day17 {
 
 using Program = std::vector<uint8_t>;
 
@@ -120,14 +124,14 @@ private:
 
 
 	static constexpr Instruction m_instructions[] {
-			&adv,
-			&bxl,
-			&bst,
-			&jnz,
-			&bxc,
-			&out,
-			&bdv,
-			&cdv,
+			&Computer::adv,
+			&Computer::bxl,
+			&Computer::bst,
+			&Computer::jnz,
+			&Computer::bxc,
+			&Computer::out,
+			&Computer::bdv,
+			&Computer::cdv,
 	};
 
 	std::function<void(uint8_t)> m_output;
@@ -141,14 +145,14 @@ class ChronospatialComputerParser
 {
 public:
 	Computer parseComputer(
-		const std::vector<std::string>& lines, 
+		const std::vector<std::string_view>& lines, 
 		std::function<void(uint8_t)> outputCallback) const
 	{
 		std::unordered_map<char, uint64_t> regs = parseRegisters(lines);
 		return { outputCallback, regs['A'], regs['B'], regs['C'] };
 	}
 
-	Program parseProgram(const std::vector<std::string>& lines)
+	Program parseProgram(const std::vector<std::string_view>& lines)
 	{
 		for (const auto& line : lines) {
 			Program p = parseProgram(line);
@@ -160,37 +164,41 @@ public:
 		return {};
 	}
 
-	Program parseProgram(const std::string& line)
+	Program parseProgram(std::string_view line)
 	{
-		std::regex regex(R"(Program:\s((\d+,)*\d+))");
+		aoc::Scanner scanner{ line };
+		if (!scanner.skip("Program:")) {
+			return {};
+		}
 
 		Program program{};
-		std::smatch match;
-		if (std::regex_match(line, match, regex)) {
-			std::string data = match[1].str();
-			std::regex dataRegex(R"(\d+)");
-			auto it = std::sregex_iterator(data.begin(), data.end(), dataRegex);
-			auto end = std::sregex_iterator();
-
-			while (it != end) {
-				program.push_back(std::stoi(it->str()));
-				++it;
+		do {
+			uint8_t value;
+			if (!scanner.tryNextInt(value)) {
+				return {};
 			}
-		}
-		return program;
+			program.push_back(value);
+		} while (scanner.skip(','));
+
+		scanner.skipWhitespace();
+		return scanner.atEnd() ? program : Program{};
 	}
 
 private:
-	std::unordered_map<char, uint64_t> parseRegisters(const std::vector<std::string>& lines) const
+	std::unordered_map<char, uint64_t> parseRegisters(const std::vector<std::string_view>& lines) const
 	{
-		std::regex regex(R"(Register\s([A-C]):\s(\d+))");
 		std::unordered_map<char, uint64_t> registers;
 
-		for (const auto& line : lines) {
-			std::smatch match;
-			if (std::regex_search(line, match, regex)) {
-				char regName = match[1].str()[0];
-				uint64_t val = std::stoull(match[2]);
+		for (std::string_view line : lines) {
+			aoc::Scanner scanner{ line };
+			if (!scanner.skip("Register ")) {
+				continue;
+			}
+
+			char regName = scanner.peek();
+			uint64_t val;
+			if (regName >= 'A' && regName <= 'C' && scanner.skip(regName) &&
+				scanner.skip(':') && scanner.tryNextInt(val)) {
 				registers[regName] = val;
 			}
 		}
@@ -255,9 +263,61 @@ private:
 	}
 };
 
+class Day17Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		auto lines = input.lines();
+		ChronospatialComputerParser parser;
+		m_computer.emplace(parser.parseComputer(lines, [](uint8_t) {}));
+		m_program = parser.parseProgram(lines);
+	}
+
+	std::string part1() override
+	{
+		std::string printed;
+		Computer computer = m_computer.value();
+		computer.setOutput([&printed](uint8_t response) {
+			printed += printed.empty() ? "" : ",";
+			printed += std::to_string(response);
+		});
+		computer.executeProgram(m_program);
+		return printed;
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(StinkySolution().firstSelfPrintingValRegA(m_program));
+	}
+
+private:
+	std::optional<Computer> m_computer;
+	Program m_program;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day17Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day17;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
@@ -267,30 +327,28 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	ChronospatialComputerParser parser;
-	StinkySolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			auto lines = aoc::loadFile(arg);
-			Computer computer = parser.parseComputer(lines,
-				[printed = false](uint8_t response) mutable {
-					std::cout << (printed ? "," : "") << (int)response;
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		ChronospatialComputerParser parser;
+		StinkySolution solution;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		Computer computer = aoc::profile("parse", [&] {
+			return parser.parseComputer(lines,
+				[&out, printed = false](uint8_t response) mutable {
+					out << (printed ? "," : "") << (int)response;
 					printed = true;
 				}
 			);
-			Program program = parser.parseProgram(lines);
-			computer.executeProgram(program);
-
-			std::cout << std::endl
-				<< "Minimal self printing register A value: "
-				<< solution.firstSelfPrintingValRegA(program)
-				<< std::endl;
+		});
+		Program program = aoc::profile("parse", [&] { return parser.parseProgram(lines); });
+		aoc::profile("part1", [&] { computer.executeProgram(program); });
 
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+		out << '\n'
+			<< "Minimal self printing register A value: "
+			<< aoc::profile("part2", [&] { return solution.firstSelfPrintingValRegA(program); })
+			<< '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,11 +1,17 @@
 ﻿#include <utils.hpp>
-#include <sstream>
-#include <queue>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <FlatHash.hpp>
+#include <Grid.hpp>
+#include <GridSearch.hpp>
+#include <DisjointSet.hpp>
+
+namespace day18 {
 
 class FallingBytesParser
 {
 public:
-	std::vector<aoc::Position> parseFallingBytes(const std::vector<std::string>& lines) const
+	std::vector<aoc::Position> parseFallingBytes(const std::vector<std::string_view>& lines) const
 	{
 		std::vector<aoc::Position> bytePoisitions;
 		for (auto& line : lines) {
@@ -17,14 +23,11 @@ public:
 	}
 
 private:
-	aoc::Position parseByte(const std::string& line) const
+	aoc::Position parseByte(std::string_view line) const
 	{
-		std::stringstream ss(line);
+		aoc::Scanner scanner{ line };
 		int64_t x,y;
-		char separator;
-		ss >> x >> separator >> y;
-
-		if (ss.fail()) {
+		if (!scanner.tryNextInt(x) || !scanner.skip(',') || !scanner.tryNextInt(y)) {
 			throw std::invalid_argument("Ill formated byte.");
 		}
 
@@ -38,63 +41,155 @@ public:
 	uint64_t exitPathLength(
 		int64_t memSizeX,
 		int64_t memSizeY,
-		const std::unordered_set<aoc::Position>& corruptedPositions) const
+		const aoc::FlatSet<aoc::Position>& corruptedPositions) const
 	{
-		static constexpr aoc::Position startPos{ 0,0 };
-		static constexpr uint64_t startCost{};
-		std::unordered_set<aoc::Position> included{startPos};
-		std::queue<std::pair<aoc::Position, uint64_t>> positionsToVisit{ {{startPos, startCost}} };
-		aoc::Position goal = { memSizeX - 1, memSizeY - 1 };
-
-		while (!positionsToVisit.empty()) {
-			const auto& [currPos, cost] = positionsToVisit.front();
-			if (currPos == goal) {
-				return cost;
-			}
-
-			for (auto& uVec : aoc::Vec2D::getUnitVectors()) {
-				const auto newPos = currPos + uVec;
-				if (memContains(newPos, memSizeX, memSizeY) && 
-					!included.contains(newPos) &&
-					!corruptedPositions.contains(newPos))
-				{
-					positionsToVisit.push({newPos, cost + 1});
-					included.insert(newPos);
-				}
+		Memory memory = emptyMemory(memSizeX, memSizeY);
+		for (const auto& bytePos : corruptedPositions) {
+			if (memory.contains(bytePos)) {
+				memory.at(bytePos) = CORRUPTED;
 			}
-			positionsToVisit.pop();
 		}
 
-		return UINT64_MAX;
+		return exitPathLength(memory);
 	}
 
+	// Lets all bytes fall and takes them back from the last one, joining
+	// every freed cell with its free neighbours. The byte whose removal first
+	// connects start and exit is the one that blocked the path.
 	aoc::Position firstBlockingByte(
 		int64_t memSizeX,
 		int64_t memSizeY,
 		const std::vector<aoc::Position>& corruptedPositions) const
 	{
-		std::unordered_set<aoc::Position> fallenBytes{};
-		for (auto& bytePos : corruptedPositions) {
-			fallenBytes.insert(bytePos);
-			uint64_t exitPathLen = exitPathLength(memSizeX, memSizeY, fallenBytes);
-			if (exitPathLen == UINT64_MAX) {
-				return bytePos;
+		Memory memory = emptyMemory(memSizeX, memSizeY);
+		// A byte falling on a corrupted cell changes nothing, only the first one counts
+		std::vector<bool> corrupts(corruptedPositions.size(), false);
+		for (size_t i = 0; i < corruptedPositions.size(); ++i) {
+			const aoc::Position& bytePos = corruptedPositions[i];
+			if (memory.contains(bytePos) && memory.at(bytePos) == FREE) {
+				memory.at(bytePos) = CORRUPTED;
+				corrupts[i] = true;
+			}
+		}
+
+		Memory::Index start = memory.index(0, 0);
+		Memory::Index goal = memory.index(memory.sizeX() - 1, memory.sizeY() - 1);
+		auto open = [&](Memory::Index idx) { return memory[idx] == FREE || idx == start; };
+		aoc::DisjointSet regions = aoc::labelGrid(memory, [&](Memory::Index from, Memory::Index to) {
+			return open(from) && open(to);
+		});
+		if (regions.connected(start, goal)) {
+			throw std::runtime_error("No blocking byte found");
+		}
+
+		const auto offsets = memory.neighbourOffsets();
+		for (size_t i = corruptedPositions.size(); i-- > 0;) {
+			if (!corrupts[i]) {
+				continue;
+			}
+
+			Memory::Index freed = memory.index(corruptedPositions[i]);
+			memory[freed] = FREE;
+			for (auto offset : offsets) {
+				if (open(freed + offset)) {
+					regions.unite(freed, freed + offset);
+				}
+			}
+
+			if (regions.connected(start, goal)) {
+				return corruptedPositions[i];
 			}
 		}
 
-		throw std::exception("No blocking byte found");
+		throw std::runtime_error("No blocking byte found");
 	}
 
 private:
-	bool memContains(const aoc::Position& p, int64_t sizeX, int64_t sizeY) const 
+	static constexpr uint8_t FREE = 0;
+	static constexpr uint8_t CORRUPTED = 1;
+	// Surrounded by corrupted cells, so a search never leaves the memory
+	using Memory = aoc::Grid<uint8_t>;
+
+	Memory emptyMemory(int64_t memSizeX, int64_t memSizeY) const
+	{
+		return Memory(memSizeX, memSizeY, FREE, 1, CORRUPTED);
+	}
+
+	uint64_t exitPathLength(const Memory& memory) const
+	{
+		static constexpr aoc::Position startPos{ 0,0 };
+		aoc::Position goalPos = { (int64_t)memory.sizeX() - 1, (int64_t)memory.sizeY() - 1 };
+		Memory::Index goal = memory.index(goalPos);
+
+		uint64_t result = UINT64_MAX;
+		aoc::gridBfs(m_search, memory, memory.index(startPos),
+			[&memory](Memory::Index, Memory::Index to) { return memory[to] == FREE; },
+			[goal, &result](Memory::Index idx, aoc::GridSearch::Distance distance) {
+				if (idx == goal) {
+					result = distance;
+				}
+				return idx != goal;
+			});
+
+		return result;
+	}
+
+	// Reused by every exitPathLength call, so repeated searches don't reallocate
+	mutable aoc::GridSearch m_search;
+};
+
+class Day18Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_bytes = FallingBytesParser().parseFallingBytes(input.lines());
+	}
+
+	std::string part1() override
+	{
+		aoc::FlatSet<aoc::Position> fallenBytes =
+			{ m_bytes.begin(), m_bytes.begin() + std::min<size_t>(fallenBytesNum, m_bytes.size()) };
+		return std::to_string(m_finder.exitPathLength(memSizeX, memSizeY, fallenBytes));
+	}
+
+	std::string part2() override
 	{
-		return p.y >= 0 && p.y < sizeY && p.x >= 0 && p.x < sizeX;
+		aoc::Position blockingByte = m_finder.firstBlockingByte(memSizeX, memSizeY, m_bytes);
+		return std::to_string(blockingByte.x) + "," + std::to_string(blockingByte.y);
 	}
+
+private:
+	static constexpr int64_t memSizeX = 71;
+	static constexpr int64_t memSizeY = 71;
+	static constexpr size_t fallenBytesNum = 1024;
+
+	std::vector<aoc::Position> m_bytes;
+	MemoryPathFinder m_finder;
 };
 
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day18Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day18;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
@@ -104,31 +199,28 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 
-	FallingBytesParser parser;
-	MemoryPathFinder solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			constexpr int64_t mSizeX = 71;
-			constexpr int64_t mSizeY = 71;
-			constexpr uint64_t fallenBytesNum = 1024;
-			auto lines = aoc::loadFile(arg);
-			auto bytes = parser.parseFallingBytes(lines);
-			std::unordered_set<aoc::Position> p1BytesSet =
-				{ bytes.begin(), bytes.begin() + fallenBytesNum };
-
-			std::cout << "Shortest exit path length for part 1: "
-				<< solution.exitPathLength(mSizeX, mSizeY, p1BytesSet)
-				<< std::endl;
-
-			auto blockingByte = solution.firstBlockingByte(mSizeX, mSizeY, bytes);
-			std::cout << "First blocking byte: "
-				<< blockingByte.x << "," << blockingByte.y
-				<< std::endl;
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		FallingBytesParser parser;
+		MemoryPathFinder solution;
+		constexpr int64_t mSizeX = 71;
+		constexpr int64_t mSizeY = 71;
+		constexpr uint64_t fallenBytesNum = 1024;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto bytes = aoc::profile("parse", [&] { return parser.parseFallingBytes(lines); });
+		aoc::FlatSet<aoc::Position> p1BytesSet =
+			{ bytes.begin(), bytes.begin() + fallenBytesNum };
+
+		out << "Shortest exit path length for part 1: "
+			<< aoc::profile("part1", [&] { return solution.exitPathLength(mSizeX, mSizeY, p1BytesSet); })
+			<< '\n';
+
+		auto blockingByte = aoc::profile("part2", [&] { return solution.firstBlockingByte(mSizeX, mSizeY, bytes); });
+		out << "First blocking byte: "
+			<< blockingByte.x << "," << blockingByte.y
+			<< '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,23 +1,29 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <ThreadPool.hpp>
+#include <MemoTable.hpp>
 #include <regex>
 #include <stack>
-#include <unordered_map>
+
+namespace day19 {
 
 class TowelParser
 {
 public:
-	std::vector<std::string> parseAvailableTowels(const std::vector<std::string>& lines) const
+	std::vector<std::string> parseAvailableTowels(const std::vector<std::string_view>& lines) const
 	{
 		if (lines.size() == 0) {
 			throw std::invalid_argument("No lines given to parse.");
 		}
 
-		const std::string& line = lines.front();
+		std::string_view line = lines.front();
 		std::regex towelRegex(R"([uwbrg]+)");
 
 		std::vector<std::string> towels;
-		auto begin = std::sregex_iterator(line.begin(), line.end(), towelRegex);
-		auto end = std::sregex_iterator();
+		using ViewRegexIterator = std::regex_iterator<std::string_view::const_iterator>;
+		auto begin = ViewRegexIterator(line.begin(), line.end(), towelRegex);
+		auto end = ViewRegexIterator();
 
 		while (begin != end) {
 			towels.push_back((*begin++).str());
@@ -26,16 +32,16 @@ public:
 		return towels;
 	}
 
-	std::vector<std::string> parsePatterns(const std::vector<std::string>& lines) const
+	std::vector<std::string> parsePatterns(const std::vector<std::string_view>& lines) const
 	{
 		std::regex patternRegex(R"([uwbrg]+)");
 		std::vector<std::string> patterns;
 		for (auto it = lines.begin() + 2; it != lines.end(); ++it) {
-			if (!std::regex_match(*it, patternRegex)) {
+			if (!std::regex_match(it->begin(), it->end(), patternRegex)) {
 				throw std::invalid_argument("Ill formated towel pattern.");
 			}
 
-			patterns.push_back(*it);
+			patterns.emplace_back(*it);
 		}
 		return patterns;
 	}
@@ -50,12 +56,15 @@ public:
 		const std::vector<std::string>& availableTowels,
 		const std::vector<std::string>& patterns) const
 	{
-		uint64_t count{};
-		for (const auto& pattern : patterns) {
-			count += isPatternPossible(availableTowels, pattern);
-		}
-
-		return count;
+		return aoc::parallelReduce(size_t{}, patterns.size(), 0, uint64_t{},
+			[&](size_t begin, size_t end) {
+				uint64_t count{};
+				for (size_t i = begin; i < end; ++i) {
+					count += isPatternPossible(availableTowels, patterns[i]);
+				}
+				return count;
+			},
+			std::plus<uint64_t>());
 	}
 
 
@@ -63,13 +72,23 @@ public:
 		const std::vector<std::string>& availableTowels,
 		const std::vector<std::string>& patterns) const
 	{
-		uint64_t count{};
-		std::unordered_map<std::string, uint64_t> cache;
+		// Cached counts don't depend on the pattern, so all chunks share one cache.
+		// Keys are views of the patterns, a pattern has at most one entry per suffix.
+		size_t suffixCount{};
 		for (const auto& pattern : patterns) {
-			count += countWaysToAchieve(availableTowels, pattern.cbegin(), pattern.cend(), cache);
+			suffixCount += pattern.size();
 		}
 
-		return count;
+		MemoTable cache(suffixCount);
+		return aoc::parallelReduce(size_t{}, patterns.size(), 0, uint64_t{},
+			[&](size_t begin, size_t end) {
+				uint64_t count{};
+				for (size_t i = begin; i < end; ++i) {
+					count += countWaysToAchieve(availableTowels, patterns[i].cbegin(), patterns[i].cend(), cache);
+				}
+				return count;
+			},
+			std::plus<uint64_t>());
 	}
 
 
@@ -130,25 +149,26 @@ public:
 
 
 private:
+	using MemoTable = aoc::MemoTable<std::string_view, uint64_t>;
+
 	uint64_t countWaysToAchieve(
 		const std::vector<std::string>& towels,
 		const std::string::const_iterator& begin,
 		const std::string::const_iterator& end,
-		std::unordered_map<std::string, uint64_t>& dp) const
+		MemoTable& dp) const
 	{
 		uint64_t count{};
 		for (const auto& towel : towels) {
 			if (patternBeginsWith(begin, end, towel)) {
 				auto newBegin = begin + towel.size();
-				std::string subPattern{ newBegin, end };
-				if(newBegin == end){
-					dp[subPattern] = 1;
+				if (newBegin == end) {
+					++count;
 				}
-				else if(!dp.contains(subPattern)){
-					dp[subPattern] = countWaysToAchieve(towels, newBegin, end, dp);
+				else {
+					count += dp.getOrCompute(std::string_view{ newBegin, end }, [&] {
+						return countWaysToAchieve(towels, newBegin, end, dp);
+					});
 				}
-
-				count += dp[subPattern];
 			}
 		}
 		return count;
@@ -175,11 +195,54 @@ private:
 	}
 };
 
+class Day19Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		auto lines = input.lines();
+		TowelParser parser;
+		m_towels = parser.parseAvailableTowels(lines);
+		m_patterns = parser.parsePatterns(lines);
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(TowelsSolution().countPossible(m_towels, m_patterns));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(TowelsSolution().countWaysToAchieve(m_towels, m_patterns));
+	}
+
+private:
+	std::vector<std::string> m_towels;
+	std::vector<std::string> m_patterns;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day19Solver>();
+}
+}
 
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day19;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
@@ -189,24 +252,21 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	TowelParser parser;
-	TowelsSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			auto lines = aoc::loadFile(arg);
-			auto towels = parser.parseAvailableTowels(lines);
-			auto patterns = parser.parsePatterns(lines);
-
-			std::cout << "Possible patterns num: "
-				<< solution.countPossible(towels, patterns)
-				<< std::endl
-				<< "Num of ways to achieve all patterns: "
-				<< solution.countWaysToAchieve(towels, patterns);
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		TowelParser parser;
+		TowelsSolution solution;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto towels = aoc::profile("parse", [&] { return parser.parseAvailableTowels(lines); });
+		auto patterns = aoc::profile("parse", [&] { return parser.parsePatterns(lines); });
+
+		out << "Possible patterns num: "
+			<< aoc::profile("part1", [&] { return solution.countPossible(towels, patterns); })
+			<< '\n'
+			<< "Num of ways to achieve all patterns: "
+			<< aoc::profile("part2", [&] { return solution.countWaysToAchieve(towels, patterns); });
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,7 +1,12 @@
 ﻿#include <utils.hpp>
-#include <unordered_map>
-#include <queue>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <Grid.hpp>
+#include <GridSearch.hpp>
 #include <iomanip>
+#include <optional>
+
+namespace day20 {
 
 class RaceTrack
 {
@@ -16,19 +21,18 @@ public:
 		aoc::Position startPos, aoc::Position endPos,
 		size_t sizeX, size_t sizeY, 
 		Field defaultField = Field::TRACK)
-		: m_sizeX{sizeX}, m_sizeY{sizeY},
-		m_startPos{startPos}, m_endPos{endPos},
-		m_fields{sizeX * sizeY, defaultField}
+		: m_startPos{startPos}, m_endPos{endPos},
+		m_fields(sizeX, sizeY, defaultField, 1, Field::WALL)
 	{}
 
 	size_t sizeX() const
 	{
-		return m_sizeX;
+		return m_fields.sizeX();
 	}
 	
 	size_t sizeY() const
 	{
-		return m_sizeY;
+		return m_fields.sizeY();
 	}
 
 	const aoc::Position& getStartPos() const
@@ -55,33 +59,36 @@ public:
 
 	bool contains(const aoc::Position& p) const
 	{
-		return p.x >= 0 && p.x < (int64_t)sizeX() && 
-			p.y >= 0 && p.y < (int64_t)sizeY();
+		return m_fields.contains(p);
+	}
+
+	const aoc::Grid<Field>& fields() const
+	{
+		return m_fields;
 	}
 
 private:
 	Field& at(const aoc::Position& p)
 	{
-		return m_fields[p.y * m_sizeY + p.x];
+		return m_fields.at(p);
 	}
 
 	const Field& at(const aoc::Position& p) const
 	{
-		return m_fields[p.y * m_sizeY + p.x];
+		return m_fields.at(p);
 	}
 
 	aoc::Position m_startPos;
 	aoc::Position m_endPos;
-	size_t m_sizeX;
-	size_t m_sizeY;
-	std::vector<Field> m_fields;
+	// Border of walls around the track
+	aoc::Grid<Field> m_fields;
 };
 
 
 class RaceTrackParser
 {
 public:
-	RaceTrack parseRaceTrack(const std::vector<std::string>& lines)
+	RaceTrack parseRaceTrack(const std::vector<std::string_view>& lines)
 	{
 		aoc::Position startPos = findStartPos(lines);
 		if (startPos == errorPos) {
@@ -108,7 +115,7 @@ public:
 	}
 
 private:
-	bool isRectangular(const std::vector<std::string>& lines) const
+	bool isRectangular(const std::vector<std::string_view>& lines) const
 	{
 		if (lines.empty()) {
 			return false;
@@ -124,7 +131,7 @@ private:
 		return true;
 	}
 
-	std::pair<size_t, size_t> getDimensions(const std::vector<std::string>& lines) const
+	std::pair<size_t, size_t> getDimensions(const std::vector<std::string_view>& lines) const
 	{
 		if (lines.empty()) {
 			throw std::invalid_argument("Given board is empty.");
@@ -140,20 +147,20 @@ private:
 		return { sizeX, sizeY };
 	}
 
-	aoc::Position findStartPos(const std::vector<std::string>& lines)
+	aoc::Position findStartPos(const std::vector<std::string_view>& lines)
 	{
 		return findSymbol(lines, startSymbol);
 	}
 
-	aoc::Position findEndPos(const std::vector<std::string>& lines)
+	aoc::Position findEndPos(const std::vector<std::string_view>& lines)
 	{
 		return findSymbol(lines, endSymbol);
 	}
 
-	aoc::Position findSymbol(const std::vector<std::string>& lines, char symbol)
+	aoc::Position findSymbol(const std::vector<std::string_view>& lines, char symbol)
 	{
 		for (int64_t y = 0; y < (int64_t)lines.size(); ++y) {
-			const std::string& line = lines[y];
+			std::string_view line = lines[y];
 			for (int64_t x = 0; x < (int64_t)line.size(); ++x) {
 				if (line[x] == symbol) {
 					return { x,y };
@@ -174,30 +181,17 @@ private:
 class ProgramPathFinder
 {
 public:
-	std::unordered_map<aoc::Position, uint64_t> getDistances(const RaceTrack& track) const
+	// Distances from the start of every track field found before reaching the end
+	aoc::GridSearch getDistances(const RaceTrack& track) const
 	{
-		aoc::Position startPos = track.getStartPos();
-		uint64_t startCost{};
-		std::queue<aoc::Position> toVisit{ { startPos } };
-		std::unordered_map<aoc::Position, uint64_t> visited{ {startPos, startCost} };
-
-		while (!toVisit.empty()) {
-			aoc::Position currPos = toVisit.front();
-			if (currPos == track.getEndPos()) {
-				break;
-			}
-			toVisit.pop();
-			uint64_t currCost = visited[currPos];
-			auto neighbourTracks = neighbours(currPos, track);
-			for (auto& field : neighbourTracks) {
-				if (!visited.contains(field)) {
-					toVisit.push(field);
-					visited.insert({ field, currCost + 1 });
-				}
-			}
-		}
-
-		return visited;
+		const auto& fields = track.fields();
+		auto end = fields.index(track.getEndPos());
+		aoc::GridSearch search;
+		aoc::gridBfs(search, fields, fields.index(track.getStartPos()),
+			[&fields](size_t, size_t to) { return fields[to] == RaceTrack::Field::TRACK; },
+			[end](size_t idx, aoc::GridSearch::Distance) { return idx != end; });
+
+		return search;
 	}
 
 	uint64_t numOfSkips(const RaceTrack& track, int64_t cheatTime, int64_t minSaved) const
@@ -206,14 +200,20 @@ public:
 			return 0;
 		}
 
-		std::unordered_map<aoc::Position, uint64_t> fields = getDistances(track);
+		const auto& fields = track.fields();
+		aoc::GridSearch distances = getDistances(track);
 		auto offsets = generateOffsetVecs(cheatTime);
 		uint64_t cnt{};
-		for (auto& field : fields) {
-			const auto& [currPos, _] = field;
+		for (size_t idx : distances.visitOrder()) {
+			std::pair<aoc::Position, uint64_t> field{ fields.position(idx), distances.distance(idx) };
 			for (const auto& offset : offsets) {
-				const auto& nPos = currPos + offset;
-				if (fields.contains(nPos) && isSkipValid(field, { nPos, fields[nPos] }, minSaved)) {
+				const auto& nPos = field.first + offset;
+				if (!track.contains(nPos)) {
+					continue;
+				}
+
+				size_t nIdx = fields.index(nPos);
+				if (distances.reached(nIdx) && isSkipValid(field, { nPos, distances.distance(nIdx) }, minSaved)) {
 					++cnt;
 				}
 			}
@@ -256,28 +256,56 @@ private:
 
 		return offsets;
 	}
+};
 
-	std::vector<aoc::Position> neighbours(
-		const aoc::Position& pos,
-		const RaceTrack& track,
-		RaceTrack::Field fieldType = RaceTrack::Field::TRACK) const
+class Day20Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
 	{
-		std::vector<aoc::Position> result;
-		for (auto& v : aoc::Vec2D::getUnitVectors()) {
-			aoc::Position newPos = pos + v;
-			if (track.contains(newPos) && track.getType(newPos) == fieldType) {
-				result.push_back(newPos);
-			}
-		}
+		aoc::MappedInput input(files.at(0));
+		m_track.emplace(RaceTrackParser().parseRaceTrack(input.lines()));
+	}
+
+	// Only the second part was kept in this file
+	std::string part1() override
+	{
+		return {};
+	}
 
-		return result;
+	std::string part2() override
+	{
+		return std::to_string(ProgramPathFinder().numOfSkips(m_track.value(), cheatTime, savedCost));
 	}
+
+private:
+	static constexpr int savedCost = 100;
+	static constexpr int cheatTime = 20;
+
+	std::optional<RaceTrack> m_track;
 };
 
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day20Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day20;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
@@ -287,22 +315,19 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	RaceTrackParser parser;
-	ProgramPathFinder solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			auto lines = aoc::loadFile(arg);
-			auto track = parser.parseRaceTrack(lines);
-			static constexpr int savedCost = 100;
-			static constexpr int cheatTime = 20;
-			std::cout << "Num of skips saving " << savedCost 
-				<< " for " << cheatTime << " ps: "
-				<< solution.numOfSkips(track, cheatTime, savedCost) << std::endl;
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		RaceTrackParser parser;
+		ProgramPathFinder solution;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto track = aoc::profile("parse", [&] { return parser.parseRaceTrack(lines); });
+		static constexpr int savedCost = 100;
+		static constexpr int cheatTime = 20;
+		out << "Num of skips saving " << savedCost 
+			<< " for " << cheatTime << " ps: "
+			<< aoc::profile("part2", [&] { return solution.numOfSkips(track, cheatTime, savedCost); }) << '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,27 +1,36 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <ThreadPool.hpp>
+#include <StreamReader.hpp>
 #include <regex>
-#include <sstream>
 #include <bit>
 #include <unordered_map>
 
+namespace day22 {
+
 class NumParser
 {
 public:
-	std::vector<uint64_t> parseNums(const std::vector<std::string>& lines)
+	std::vector<uint64_t> parseNums(const std::vector<std::string_view>& lines)
 	{
 		std::vector<uint64_t> nums;
 		for (auto& line : lines) {
-			std::stringstream ss(line);
-			uint64_t num;
-			ss >> num;
-			if (ss.fail()) {
-				throw std::invalid_argument("Invalid number format.");
-			}
-			nums.push_back(num);
+			nums.push_back(parseNum(line));
 		}
 
 		return nums;
 	}
+
+	uint64_t parseNum(std::string_view line) const
+	{
+		aoc::Scanner scanner{ line };
+		uint64_t num;
+		if (!scanner.tryNextInt(num)) {
+			throw std::invalid_argument("Invalid number format.");
+		}
+		return num;
+	}
 };
 
 class Sequence
@@ -69,44 +78,64 @@ private:
 	};
 };
 
+}
+
 template <> 
-struct std::hash<Sequence>
+struct std::hash<day22::Sequence>
 {
-	size_t operator()(const Sequence& sequence) const
+	size_t operator()(const day22::Sequence& sequence) const
 	{
 		return sequence.getHash();
 	}
 };
 
+namespace day22 {
+
 class MonkeysSolution
 {
 public:
 	uint64_t maxBananasNum(const std::vector<uint64_t>& initialNums, uint64_t itNum) const
 	{
-		std::unordered_map<Sequence, uint64_t> bananasPerSequenceSum;
-		for (auto num : initialNums) {
-			auto&& sequencesToBananas = possibleBananas(num, itNum);
-			for (auto& el : sequencesToBananas) {
-				bananasPerSequenceSum[el.first] += el.second;
-			}
-		}
+		return maxBananas(sumBananasPerSequence(initialNums, itNum));
+	}
 
-		uint64_t maxBananas{};
-		for (auto& el : bananasPerSequenceSum) {
-			maxBananas = std::max(maxBananas, el.second);
-		}
+	// Both answers for a file read in batches of fixed size. Between batches
+	// only the sums per sequence are kept, and there are at most 19^4 of them.
+	std::pair<uint64_t, uint64_t> solveStreaming(aoc::StreamReader& reader, const NumParser& parser, uint64_t itNum) const
+	{
+		static constexpr size_t BATCH_SIZE = 1024;
+		uint64_t secretNumsSum{};
+		BananasMap bananasPerSequenceSum;
+		std::vector<uint64_t> batch;
+		batch.reserve(BATCH_SIZE);
+		auto solveBatch = [&] {
+			secretNumsSum += sumSecretNums(batch, itNum);
+			bananasPerSequenceSum = mergeBananas(std::move(bananasPerSequenceSum), sumBananasPerSequence(batch, itNum));
+			batch.clear();
+		};
 
-		return maxBananas;
+		reader.forEachLine([&](std::string_view line) {
+			batch.push_back(parser.parseNum(line));
+			if (batch.size() == BATCH_SIZE) {
+				solveBatch();
+			}
+		});
+		solveBatch();
+
+		return { secretNumsSum, maxBananas(bananasPerSequenceSum) };
 	}
 
 	uint64_t sumSecretNums(const std::vector<uint64_t>& nums, uint64_t itNum) const
 	{
-		uint64_t sum{};
-		for (auto& num : nums) {
-			sum += getSecretNumAfter(num, itNum);
-		}
-		
-		return sum;
+		return aoc::parallelReduce(size_t{}, nums.size(), 0, uint64_t{},
+			[&](size_t begin, size_t end) {
+				uint64_t sum{};
+				for (size_t i = begin; i < end; ++i) {
+					sum += getSecretNumAfter(nums[i], itNum);
+				}
+				return sum;
+			},
+			std::plus<uint64_t>());
 	}
 
 	uint64_t getSecretNumAfter(uint64_t num, uint64_t numOfIterations) const
@@ -136,6 +165,39 @@ public:
 	}
 
 private:
+	using BananasMap = std::unordered_map<Sequence, uint64_t>;
+
+	static BananasMap mergeBananas(BananasMap into, const BananasMap& from)
+	{
+		for (auto& el : from) {
+			into[el.first] += el.second;
+		}
+		return into;
+	}
+
+	BananasMap sumBananasPerSequence(const std::vector<uint64_t>& initialNums, uint64_t itNum) const
+	{
+		return aoc::parallelReduce(size_t{}, initialNums.size(), 0, BananasMap{},
+			[&](size_t begin, size_t end) {
+				BananasMap chunkSum;
+				for (size_t i = begin; i < end; ++i) {
+					chunkSum = mergeBananas(std::move(chunkSum), possibleBananas(initialNums[i], itNum));
+				}
+				return chunkSum;
+			},
+			mergeBananas);
+	}
+
+	static uint64_t maxBananas(const BananasMap& bananasPerSequenceSum)
+	{
+		uint64_t maxBananas{};
+		for (auto& el : bananasPerSequenceSum) {
+			maxBananas = std::max(maxBananas, el.second);
+		}
+
+		return maxBananas;
+	}
+
 	uint64_t prune(uint64_t oldSecretNum) const
 	{
 		// modulo 16777216
@@ -183,9 +245,53 @@ private:
 	}
 };
 
+class Day22Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		m_nums = NumParser().parseNums(input.lines());
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(MonkeysSolution().sumSecretNums(m_nums, numOfIterations));
+	}
+
+	std::string part2() override
+	{
+		return std::to_string(MonkeysSolution().maxBananasNum(m_nums, numOfIterations));
+	}
+
+private:
+	static constexpr uint64_t numOfIterations = 2000;
+
+	std::vector<uint64_t> m_nums;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day22Solver>();
+}
+}
+
+
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day22;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runArgs, "--stream");
 	if (runArgs.empty()) {
 		const std::string defaultFile = "example.txt";
 		std::cerr << "No args given, running default file: " 
@@ -194,25 +300,30 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	NumParser parser;
-	MonkeysSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			static constexpr uint64_t numOfIterations = 2000;
-			auto lines = aoc::loadFile(arg);
-			auto nums = parser.parseNums(lines);
-			std::cout 
-				<< "Sum of secret nums after " << numOfIterations << ": "
-				<< solution.sumSecretNums(nums, numOfIterations) 
-				<< std::endl
-				<< "Max number of bananas: "
-				<< solution.maxBananasNum(nums, numOfIterations) 
-				<< std::endl;
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		NumParser parser;
+		MonkeysSolution solution;
+		static constexpr uint64_t numOfIterations = 2000;
+		if (streaming) {
+			aoc::StreamReader reader(arg);
+			auto [secretNumsSum, maxBananas] = aoc::profile("stream", [&] { return solution.solveStreaming(reader, parser, numOfIterations); });
+			out << "Sum of secret nums after " << numOfIterations << ": " << secretNumsSum << '\n'
+				<< "Max number of bananas: " << maxBananas << '\n';
+			return;
 		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto nums = aoc::profile("parse", [&] { return parser.parseNums(lines); });
+		out 
+			<< "Sum of secret nums after " << numOfIterations << ": "
+			<< aoc::profile("part1", [&] { return solution.sumSecretNums(nums, numOfIterations); }) 
+			<< '\n'
+			<< "Max number of bananas: "
+			<< aoc::profile("part2", [&] { return solution.maxBananasNum(nums, numOfIterations); }) 
+			<< '\n';
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
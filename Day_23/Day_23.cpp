@@ -1,32 +1,51 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <CsrGraph.hpp>
 #include <regex>
-#include <set>
-#include <unordered_map>
-#include <queue>
+#include <algorithm>
 
-using ConnectionMap = std::unordered_map<std::string, std::unordered_set<std::string>>;
+namespace day23 {
+
+// Computers are the vertices, the interner keeps their names.
+// Every connection is stored in both directions.
+struct Network
+{
+	aoc::LabelInterner<std::string> computers;
+	aoc::CsrGraph<> connections;
+};
 
 class ComputerParser
 {
 public:
-	ConnectionMap parseNetwork(const std::vector<std::string>& lines) const
+	Network parseNetwork(const std::vector<std::string_view>& lines) const
 	{
-		ConnectionMap map;
+		Network network;
+		std::vector<aoc::CsrGraph<>::Edge> edges;
 		for (auto& line : lines) {
 			auto [first, second] = parseComputerPair(line);
-			map[first].insert(second);
-			map[second].insert(first);
+			aoc::Vertex a = network.computers.intern(first);
+			aoc::Vertex b = network.computers.intern(second);
+			edges.push_back({ a, b });
+			edges.push_back({ b, a });
 		}
 
-		return map;
+		// A connection listed twice is still one edge
+		auto asPair = [](const auto& edge) { return std::pair{ edge.from, edge.to }; };
+		std::sort(edges.begin(), edges.end(), [&](const auto& a, const auto& b) { return asPair(a) < asPair(b); });
+		edges.erase(std::unique(edges.begin(), edges.end(),
+			[&](const auto& a, const auto& b) { return asPair(a) == asPair(b); }), edges.end());
+
+		network.connections = aoc::CsrGraph<>(network.computers.size(), edges);
+		return network;
 	}
 
 private:
-	std::pair<std::string, std::string> parseComputerPair(const std::string& line) const
+	std::pair<std::string, std::string> parseComputerPair(std::string_view line) const
 	{
 		std::regex regex(R"(^([a-z]+)\-([a-z]+)$)");
-		std::smatch match;
-		if (std::regex_match(line, match, regex)) {
+		std::match_results<std::string_view::const_iterator> match;
+		if (std::regex_match(line.begin(), line.end(), match, regex)) {
 			return{ match[1].str(), match[2].str() };
 		}
 		
@@ -34,129 +53,88 @@ private:
 	}
 };
 
-struct Clique
+class SolutionLAN
 {
-	std::set<std::string> elements;
-	bool operator==(const Clique& c) const 
+public:
+	// Triangles of connected computers with at least one name starting with t.
+	// Every triangle a < b < c is found once, from a over b, and the
+	// sorted connection lists make checking a-c a binary search.
+	uint64_t countCliques(const Network& network) const
 	{
-		if (elements.size() != c.elements.size()) {
-			return false;
-		}
-
-		for (auto& n : elements) {
-			if (!c.elements.contains(n)) {
-				return false;
+		const aoc::CsrGraph<>& graph = network.connections;
+		uint64_t count{};
+		for (aoc::Vertex a = 0; a < graph.vertexCount(); ++a) {
+			for (aoc::Vertex b : graph.targets(a)) {
+				if (b <= a) {
+					continue;
+				}
+
+				for (aoc::Vertex c : graph.targets(b)) {
+					if (c <= b || !graph.hasEdge(a, c)) {
+						continue;
+					}
+
+					if (startsWith(network, a, 't') || startsWith(network, b, 't') || startsWith(network, c, 't')) {
+						++count;
+					}
+				}
 			}
 		}
 
-		return true;
+		return count;
 	}
 
-	bool containsNodeStartingWith(char c) const
+private:
+	bool startsWith(const Network& network, aoc::Vertex computer, char c) const
 	{
-		for (auto& el : elements) {
-			if (el[0] == c) {
-				return true;
-			}
-		}
-		return false;
+		return network.computers.label(computer).front() == c;
 	}
 };
 
-template<>
-struct std::hash<Clique>
+class Day23Solver : public aoc::Solver
 {
-	size_t operator()(const Clique& c) const 
+public:
+	void parse(const std::vector<std::string>& files) override
 	{
-		size_t hash{};
-		for (auto& el : c.elements) {
-			hash = (hash << 1) ^ std::hash<std::string>{}(el);
-		}
-		return hash;
+		aoc::MappedInput input(files.at(0));
+		m_network = ComputerParser().parseNetwork(input.lines());
 	}
-};
 
-class SolutionLAN
-{
-public:
-	uint64_t countCliques(const ConnectionMap& map) const
+	std::string part1() override
 	{
-		std::unordered_set<Clique> cliques;
-		for (const auto& [nodeName, _] : map) {
-			const auto& foundCliques = getCliques(map, {}, nodeName, 3);
-			aoc::insertSet(foundCliques, cliques);
-		}
-
-		for (auto it = cliques.begin(); it != cliques.end();) {
-			if (it->elements.size() != 3) {
-				it = cliques.erase(it);
-			}
-			else if (!it->containsNodeStartingWith('t')) {
-				it = cliques.erase(it);
-			}
-			else {
-				++it;
-			}
-		}
-
-		return cliques.size();
+		return std::to_string(SolutionLAN().countCliques(m_network));
 	}
 
-private:
-	std::unordered_set<Clique> getCliques(
-		const ConnectionMap& connections,
-		std::set<std::string> previousNodes,
-		const std::string& nodeName,
-		int64_t maxSize) const
+	std::string part2() override
 	{
-		if (!connections.contains(nodeName)) {
-			return {};
-		}
-
-		if (maxSize < 0) {
-			return {};
-		}
-
-		if (!nodeHasConnections(connections, nodeName, previousNodes)) {
-			Clique clique;
-			clique.elements = previousNodes;
-			return { clique };
-		}
-
-		previousNodes.insert(nodeName);
-		std::unordered_set<Clique> cliques;
-		auto& neighbours = connections.at(nodeName);
-		for (auto& neighbour : neighbours) {
-			const auto& foundCliques = getCliques(connections, previousNodes, neighbour, maxSize - 1);
-			aoc::insertSet(foundCliques, cliques);
-		}
-
-		return cliques;
+		return {};
 	}
 
-	bool nodeHasConnections(
-		const ConnectionMap& connections,
-		const std::string& nodeName,
-		const std::set<std::string>& toNodes) const 
-	{
-		if (!connections.contains(nodeName)) {
-			return false;
-		}
+private:
+	Network m_network;
+};
 
-		const auto& nodeConnections = connections.at(nodeName);
-		for (auto& node : toNodes) {
-			if (!nodeConnections.contains(node)) {
-				return false;
-			}
-		}
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day23Solver>();
+}
+}
 
-		return true;
-	}
-};
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day23;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
 		std::cerr << "No args given, running default file: " 
@@ -165,19 +143,16 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	ComputerParser parser;
-	SolutionLAN solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			static constexpr uint64_t numOfIterations = 2000;
-			auto lines = aoc::loadFile(arg);
-			auto network = parser.parseNetwork(lines);
-			std::cout << solution.countCliques(network);
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
-		}
-	}
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		ComputerParser parser;
+		SolutionLAN solution;
+		static constexpr uint64_t numOfIterations = 2000;
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto network = aoc::profile("parse", [&] { return parser.parseNetwork(lines); });
+		out << aoc::profile("part1", [&] { return solution.countCliques(network); });
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
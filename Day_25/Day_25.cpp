@@ -1,4 +1,10 @@
 ﻿#include <utils.hpp>
+#include <Solver.hpp>
+#include <Batch.hpp>
+#include <StreamReader.hpp>
+#include <map>
+
+namespace day25 {
 
 class Lock
 {
@@ -27,6 +33,8 @@ public:
 		return m_lockVals[pos];
 	}
 
+	auto operator<=>(const Lock&) const = default;
+
 private:
 	std::vector<int64_t> m_lockVals;
 	int64_t m_lockHeight;
@@ -71,6 +79,8 @@ public:
 		return true;
 	}
 
+	auto operator<=>(const Key&) const = default;
+
 private:
 	std::vector<int64_t> m_keyVals;
 };
@@ -78,7 +88,7 @@ private:
 class KeyLockParser
 {
 public:
-	std::vector<Key> parseKeys(const std::vector<std::string>& lines) const
+	std::vector<Key> parseKeys(const std::vector<std::string_view>& lines) const
 	{
 		std::vector<Key> result;
 		for (auto begIt = lines.cbegin(); begIt != lines.cend(); begIt++) {
@@ -97,7 +107,7 @@ public:
 		return result;
 	}
 
-	std::vector<Lock> parseLocks(const std::vector<std::string>& lines) const
+	std::vector<Lock> parseLocks(const std::vector<std::string_view>& lines) const
 	{
 		std::vector<Lock> result;
 		for (auto begIt = lines.cbegin(); begIt != lines.cend(); begIt++) {
@@ -116,9 +126,19 @@ public:
 		return result;
 	}
 
+	bool isKey(std::string_view firstLine) const
+	{
+		return isFullySolid(firstLine);
+	}
+
+	bool isLock(std::string_view firstLine) const
+	{
+		return isFullyEmpty(firstLine);
+	}
+
 	Key parseKey(
-		std::vector<std::string>::const_iterator begin,
-		const std::vector<std::string>::const_iterator& end) const
+		std::vector<std::string_view>::const_iterator begin,
+		const std::vector<std::string_view>::const_iterator& end) const
 	{
 		size_t keyLength = begin->size();
 		Key parsedKey(keyLength);
@@ -149,8 +169,8 @@ public:
 	}
 
 	Lock parseLock(
-		std::vector<std::string>::const_iterator begin,
-		const std::vector<std::string>::const_iterator& end) const
+		std::vector<std::string_view>::const_iterator begin,
+		const std::vector<std::string_view>::const_iterator& end) const
 	{
 		size_t lockLength = begin->size();
 		int64_t lockHeight = std::distance(begin, end) + 1;
@@ -183,11 +203,11 @@ public:
 
 private:
 	auto findElementEnd(
-		const std::vector<std::string>::const_iterator& begIt,
-		const std::vector<std::string>::const_iterator& vecEnd) const
-		-> std::vector<std::string>::const_iterator
+		const std::vector<std::string_view>::const_iterator& begIt,
+		const std::vector<std::string_view>::const_iterator& vecEnd) const
+		-> std::vector<std::string_view>::const_iterator
 	{
-		std::vector<std::string>::const_iterator endIt = begIt;
+		std::vector<std::string_view>::const_iterator endIt = begIt;
 		while (endIt != vecEnd && !endIt->empty()) {
 			endIt++;
 		}
@@ -195,19 +215,19 @@ private:
 		return endIt;
 	}
 
-	bool isFullySolid(const std::string& s) const
+	bool isFullySolid(std::string_view s) const
 	{
-		return s.find_first_not_of(solidSymbol) == std::string::npos;
+		return s.find_first_not_of(solidSymbol) == std::string_view::npos;
 	}
 
-	bool isFullyEmpty(const std::string& s) const
+	bool isFullyEmpty(std::string_view s) const
 	{
-		return s.find_first_not_of(emptySymbol) == std::string::npos;
+		return s.find_first_not_of(emptySymbol) == std::string_view::npos;
 	}
 
-	bool containsIllegalChar(const std::string& s) const
+	bool containsIllegalChar(std::string_view s) const
 	{
-		return s.find_first_not_of({emptySymbol, solidSymbol}) != std::string::npos;
+		return s.find_first_not_of(std::string{emptySymbol, solidSymbol}) != std::string_view::npos;
 	}
 
 	bool isSolid(char c) const
@@ -248,12 +268,85 @@ public:
 
 		return cnt;
 	}
+
+	// Keys and locks read one by one. Equal shapes are only counted, so memory
+	// depends on the number of different shapes, not on the file size.
+	uint64_t countFittingKeysStreaming(aoc::StreamReader& reader, const KeyLockParser& parser)
+	{
+		std::map<Key, uint64_t> keyCounts;
+		std::map<Lock, uint64_t> lockCounts;
+		reader.forEachRecord([&](std::string_view record) {
+			std::vector<std::string_view> lines = aoc::splitLines(record);
+			if (parser.isKey(lines.front())) {
+				++keyCounts[parser.parseKey(lines.cbegin(), lines.cend())];
+			}
+			else if (parser.isLock(lines.front())) {
+				++lockCounts[parser.parseLock(lines.cbegin(), lines.cend())];
+			}
+		});
+
+		uint64_t cnt{};
+		for (const auto& [lock, lockCount] : lockCounts) {
+			for (const auto& [key, keyCount] : keyCounts) {
+				if (key.fits(lock)) {
+					cnt += lockCount * keyCount;
+				}
+			}
+		}
+
+		return cnt;
+	}
 };
 
+class Day25Solver : public aoc::Solver
+{
+public:
+	void parse(const std::vector<std::string>& files) override
+	{
+		aoc::MappedInput input(files.at(0));
+		auto lines = input.lines();
+		KeyLockParser parser;
+		m_keys = parser.parseKeys(lines);
+		m_locks = parser.parseLocks(lines);
+	}
+
+	std::string part1() override
+	{
+		return std::to_string(LocksSolution().countFittingKeys(m_locks, m_keys));
+	}
+
+	std::string part2() override
+	{
+		return {};
+	}
+
+private:
+	std::vector<Key> m_keys;
+	std::vector<Lock> m_locks;
+};
+
+std::unique_ptr<aoc::Solver> makeSolver()
+{
+	return std::make_unique<Day25Solver>();
+}
+}
+
 
+#ifndef AOC_SOLVER_LIBRARY
 int main(int argc, char* args[])
 {
+	using namespace day25;
+
 	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		aoc::expandManifests(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	bool streaming = aoc::consumeFlag(runArgs, "--stream");
 	if (runArgs.empty()) {
 		const std::string defaultFile = "input.txt";
 		std::cerr << "No args given, running default file: " 
@@ -262,20 +355,23 @@ int main(int argc, char* args[])
 		runArgs.push_back(defaultFile);
 	}
 	
-	KeyLockParser parser;
-	LocksSolution solution;
-	for (const std::string& arg : runArgs) {
-		try {
-			static constexpr uint64_t numOfIterations = 2000;
-			auto lines = aoc::loadFile(arg);
-			auto keys = parser.parseKeys(lines);
-			auto locks = parser.parseLocks(lines);
-			std::cout << solution.countFittingKeys(locks, keys);
-		}
-		catch (std::exception& e) {
-			std::cerr << e.what() << std::endl;
+	aoc::runBatch(runArgs, [&](const std::string& arg, std::ostream& out) {
+		KeyLockParser parser;
+		LocksSolution solution;
+		static constexpr uint64_t numOfIterations = 2000;
+		if (streaming) {
+			aoc::StreamReader reader(arg);
+			out << aoc::profile("stream", [&] { return solution.countFittingKeysStreaming(reader, parser); });
+			return;
 		}
-	}
+
+		aoc::MappedInput input = aoc::profile("load", [&] { return aoc::MappedInput(arg); });
+		auto lines = input.lines();
+		auto keys = aoc::profile("parse", [&] { return parser.parseKeys(lines); });
+		auto locks = aoc::profile("parse", [&] { return parser.parseLocks(lines); });
+		out << aoc::profile("part1", [&] { return solution.countFittingKeys(locks, keys); });
+	});
 
 	return 0;
-}
\ No newline at end of file
+}
+#endif
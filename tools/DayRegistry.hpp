@@ -0,0 +1,61 @@
+#pragma once
+#include <Solver.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Every day built into the tool, generated by CMake from the Day_XX directories.
+// Tools including this link all the Day_XX_solver libraries.
+#define AOC_DAY(num) namespace day##num { std::unique_ptr<aoc::Solver> makeSolver(); }
+#include "Days.inc"
+#undef AOC_DAY
+
+struct DayEntry
+{
+	std::string name;
+	std::unique_ptr<aoc::Solver>(*makeSolver)();
+};
+
+inline const std::vector<DayEntry>& allDays()
+{
+	static const std::vector<DayEntry> days{
+#define AOC_DAY(num) { "Day_" #num, &day##num::makeSolver },
+#include "Days.inc"
+#undef AOC_DAY
+	};
+	return days;
+}
+
+// Accepts a day number or a Day_XX name, nullptr when no such day is built
+inline const DayEntry* findDay(std::string dayName)
+{
+	if (!dayName.starts_with("Day_")) {
+		dayName = std::string(dayName.size() < 2 ? "Day_0" : "Day_") + dayName;
+	}
+
+	auto it = std::find_if(allDays().begin(), allDays().end(),
+		[&](const DayEntry& day) { return day.name == dayName; });
+	return it != allDays().end() ? &*it : nullptr;
+}
+
+// Existing paths are taken as given, others are looked up in the day's source directory
+inline std::string resolveDayFile(const DayEntry& day, const std::string& file, const std::filesystem::path& sourceDir)
+{
+	if (std::filesystem::exists(file)) {
+		return file;
+	}
+	return (sourceDir / day.name / file).string();
+}
+
+// Default inputs always come from the source directory, whatever is in the working one
+inline std::vector<std::string> defaultDayFiles(const DayEntry& day, const std::filesystem::path& sourceDir)
+{
+	std::filesystem::path dayDir = sourceDir / day.name;
+	// Day 5 is the only one with its input split into two files
+	if (day.name == "Day_05") {
+		return { (dayDir / "inputRules.txt").string(), (dayDir / "inputQueues.txt").string() };
+	}
+	return { (dayDir / "input.txt").string() };
+}
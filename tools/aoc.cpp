@@ -0,0 +1,187 @@
+#include <utils.hpp>
+#include <Solver.hpp>
+#include <ThreadPool.hpp>
+#include "DayRegistry.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+// All days in one process: they share the thread pool, the profiler and the
+// loader, and a sweep over every day starts one process instead of one per day.
+
+struct RunTarget
+{
+	const DayEntry* day;
+	std::vector<std::string> files;
+};
+
+struct RunOptions
+{
+	std::string command;
+	std::filesystem::path sourceDir = AOC_SOURCE_DIR;
+	std::vector<RunTarget> targets;
+};
+
+
+class RunArgsParser
+{
+public:
+	RunOptions parse(const std::vector<std::string>& args) const
+	{
+		if (args.empty()) {
+			throw std::invalid_argument("No command given, see --help");
+		}
+
+		RunOptions options;
+		options.command = args.front();
+		if (options.command == "list") {
+			return options;
+		}
+		if (options.command != "run") {
+			throw std::invalid_argument("Unknown command: " + options.command);
+		}
+
+		std::vector<std::string> operands;
+		for (size_t i = 1; i < args.size(); ++i) {
+			if (args[i] == "--source-dir") {
+				if (i + 1 >= args.size()) {
+					throw std::invalid_argument("Missing value for --source-dir");
+				}
+				options.sourceDir = args[++i];
+			}
+			else if (args[i].starts_with("--")) {
+				throw std::invalid_argument("Unknown option: " + args[i]);
+			}
+			else {
+				operands.push_back(args[i]);
+			}
+		}
+
+		if (operands.empty()) {
+			throw std::invalid_argument("No day given to run");
+		}
+
+		if (operands.size() == 1 && operands.front() == "all") {
+			for (const DayEntry& day : allDays()) {
+				RunTarget target{ &day, defaultDayFiles(day, options.sourceDir) };
+				if (std::all_of(target.files.begin(), target.files.end(),
+					[](const std::string& f) { return std::filesystem::exists(f); })) {
+					options.targets.push_back(std::move(target));
+				}
+			}
+			return options;
+		}
+
+		// A day is followed by its files, a day without any runs its default input
+		for (const std::string& operand : operands) {
+			if (const DayEntry* day = asDay(operand)) {
+				options.targets.push_back({ day, {} });
+			}
+			else if (options.targets.empty()) {
+				throw std::invalid_argument("Unknown day: " + operand);
+			}
+			else {
+				RunTarget& target = options.targets.back();
+				target.files.push_back(resolveDayFile(*target.day, operand, options.sourceDir));
+			}
+		}
+
+		for (RunTarget& target : options.targets) {
+			if (target.files.empty()) {
+				target.files = defaultDayFiles(*target.day, options.sourceDir);
+			}
+		}
+		return options;
+	}
+
+	static void printUsage(std::ostream& out)
+	{
+		out << "Usage: aoc COMMAND [options]\n"
+			<< "  run DAY [FILE...]... solve days, a day without files solves its default\n"
+			<< "                       input from the day's source directory\n"
+			<< "  run all              solve every day that has its default input\n"
+			<< "  list                 print the days built into aoc\n"
+			<< "  --source-dir DIR     repository root used for default inputs\n"
+			<< "  --threads N          threads of the shared pool, the calling one included\n"
+			<< "DAY is a day number or Day_XX name. With AOC_PROFILE set, every day's\n"
+			<< "steps are timed as Day_XX/parse, Day_XX/part1 and Day_XX/part2.\n";
+	}
+
+private:
+	// Only names of built days count, anything else is a file
+	const DayEntry* asDay(const std::string& operand) const
+	{
+		bool isNumber = !operand.empty() && operand.size() <= 2
+			&& std::all_of(operand.begin(), operand.end(), [](char c) { return c >= '0' && c <= '9'; });
+		if (!isNumber && !operand.starts_with("Day_")) {
+			return nullptr;
+		}
+		return findDay(operand);
+	}
+};
+
+
+// Returns false when the day threw, its error goes to err
+bool solveDay(const RunTarget& target, std::ostream& out, std::ostream& err)
+{
+	try {
+		aoc::ScopedPhase dayPhase(target.day->name);
+		std::unique_ptr<aoc::Solver> solver = target.day->makeSolver();
+		aoc::profile("parse", [&] { solver->parse(target.files); });
+		std::string part1 = aoc::profile("part1", [&] { return solver->part1(); });
+		std::string part2 = aoc::profile("part2", [&] { return solver->part2(); });
+
+		// A part the day doesn't solve answers with an empty string
+		out << target.day->name << "\n";
+		if (!part1.empty()) {
+			out << "  part1: " << part1 << "\n";
+		}
+		if (!part2.empty()) {
+			out << "  part2: " << part2 << "\n";
+		}
+		out.flush();
+		return true;
+	}
+	catch (std::exception& e) {
+		err << target.day->name << ": " << e.what() << std::endl;
+		return false;
+	}
+}
+
+int main(int argc, char* args[])
+{
+	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	if (std::find(runArgs.begin(), runArgs.end(), "--help") != runArgs.end()) {
+		RunArgsParser::printUsage(std::cout);
+		return 0;
+	}
+
+	RunOptions options;
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		options = RunArgsParser().parse(runArgs);
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	if (options.command == "list") {
+		for (const DayEntry& day : allDays()) {
+			std::cout << day.name << "\n";
+		}
+		return 0;
+	}
+
+	if (options.targets.empty()) {
+		std::cerr << "No inputs found, nothing to run." << std::endl;
+		return 1;
+	}
+
+	size_t failed = 0;
+	for (const RunTarget& target : options.targets) {
+		failed += !solveDay(target, std::cout, std::cerr);
+	}
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,454 @@
+#include <utils.hpp>
+#include <Solver.hpp>
+#include <ThreadPool.hpp>
+#include "DayRegistry.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <charconv>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+struct BenchTarget
+{
+	const DayEntry* day;
+	std::vector<std::string> files;
+};
+
+struct BenchOptions
+{
+	size_t runs = 10;
+	size_t warmup = 2;
+	int cpu = -1;
+	bool counters = false;
+	double thresholdPercent = 5.0;
+	std::string baselinePath;
+	std::string saveBaselinePath;
+	std::filesystem::path sourceDir = AOC_SOURCE_DIR;
+	std::vector<BenchTarget> targets;
+};
+
+
+class BenchArgsParser
+{
+public:
+	BenchOptions parse(const std::vector<std::string>& args) const
+	{
+		BenchOptions options;
+		for (size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			if (arg == "--runs") {
+				options.runs = std::max<size_t>(1, parseNumber<size_t>(arg, value(args, i)));
+			}
+			else if (arg == "--warmup") {
+				options.warmup = parseNumber<size_t>(arg, value(args, i));
+			}
+			else if (arg == "--cpu") {
+				options.cpu = parseNumber<int>(arg, value(args, i));
+			}
+			else if (arg == "--counters") {
+				options.counters = true;
+			}
+			else if (arg == "--threshold") {
+				options.thresholdPercent = parseNumber<double>(arg, value(args, i));
+			}
+			else if (arg == "--baseline") {
+				options.baselinePath = value(args, i);
+			}
+			else if (arg == "--save-baseline") {
+				options.saveBaselinePath = value(args, i);
+			}
+			else if (arg == "--source-dir") {
+				options.sourceDir = value(args, i);
+			}
+			else if (arg.starts_with("--")) {
+				throw std::invalid_argument("Unknown option: " + arg);
+			}
+			else {
+				options.targets.push_back(parseTarget(arg, options.sourceDir));
+			}
+		}
+
+		if (options.targets.empty()) {
+			for (const DayEntry& day : allDays()) {
+				BenchTarget target{ &day, defaultDayFiles(day, options.sourceDir) };
+				if (std::all_of(target.files.begin(), target.files.end(),
+					[](const std::string& f) { return std::filesystem::exists(f); })) {
+					options.targets.push_back(std::move(target));
+				}
+			}
+		}
+
+		return options;
+	}
+
+	static void printUsage(std::ostream& out)
+	{
+		out << "Usage: aoc_bench [options] [DAY[=file[,file...]]]...\n"
+			<< "  DAY                  day number or Day_XX name, default input is taken\n"
+			<< "                       from the day's source directory\n"
+			<< "  --runs N             measured runs of every step (10)\n"
+			<< "  --warmup N           unmeasured runs before measuring (2)\n"
+			<< "  --cpu K              pin the benchmark to CPU K\n"
+			<< "  --counters           read hardware counters of every step too (Linux)\n"
+			<< "  --baseline FILE      compare medians with a saved baseline\n"
+			<< "  --save-baseline FILE write medians of this run as a baseline\n"
+			<< "  --threshold P        percent a median may grow before it's a regression (5)\n"
+			<< "  --source-dir DIR     repository root used for default inputs\n"
+			<< "  --threads N          threads of the shared pool, the calling one included\n"
+			<< "Without DAY arguments every day that has its default input is run.\n";
+	}
+
+private:
+	const std::string& value(const std::vector<std::string>& args, size_t& i) const
+	{
+		if (i + 1 >= args.size()) {
+			throw std::invalid_argument("Missing value for " + args[i]);
+		}
+		return args[++i];
+	}
+
+	template<typename T>
+	T parseNumber(const std::string& option, const std::string& text) const
+	{
+		T result{};
+		auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), result);
+		if (ec != std::errc{} || ptr != text.data() + text.size()) {
+			throw std::invalid_argument("Invalid value for " + option + ": " + text);
+		}
+		return result;
+	}
+
+	BenchTarget parseTarget(const std::string& arg, const std::filesystem::path& sourceDir) const
+	{
+		size_t eqPos = arg.find('=');
+		const DayEntry* day = findDay(arg.substr(0, eqPos));
+		if (day == nullptr) {
+			throw std::invalid_argument("Unknown day: " + arg);
+		}
+
+		if (eqPos == std::string::npos) {
+			return { day, defaultDayFiles(*day, sourceDir) };
+		}
+
+		BenchTarget target{ day, {} };
+		std::stringstream files(arg.substr(eqPos + 1));
+		std::string file;
+		while (std::getline(files, file, ',')) {
+			target.files.push_back(resolveDayFile(*day, file, sourceDir));
+		}
+		return target;
+	}
+};
+
+
+class Bench
+{
+public:
+	explicit Bench(const BenchOptions& options)
+		: m_options{ options }
+	{}
+
+	void run()
+	{
+		aoc::Profiler& profiler = aoc::Profiler::instance();
+		for (const BenchTarget& target : m_options.targets) {
+			std::unique_ptr<aoc::Solver> solver = target.day->makeSolver();
+
+			profiler.setEnabled(false);
+			for (size_t i = 0; i < m_options.warmup; ++i) {
+				runOnce(*target.day, *solver, target.files);
+			}
+
+			profiler.setEnabled(true);
+			for (size_t i = 0; i < m_options.runs; ++i) {
+				runOnce(*target.day, *solver, target.files);
+			}
+			profiler.setEnabled(false);
+		}
+	}
+
+	void printAnswers(std::ostream& out) const
+	{
+		for (const auto& [name, answer] : m_answers) {
+			if (!answer.empty()) {
+				out << name << ": " << answer << "\n";
+			}
+		}
+	}
+
+private:
+	void runOnce(const DayEntry& day, aoc::Solver& solver, const std::vector<std::string>& files)
+	{
+		aoc::ScopedPhase dayPhase(day.name);
+		aoc::profile("parse", [&] { solver.parse(files); });
+		checkAnswer(day.name + "/part1", aoc::profile("part1", [&] { return solver.part1(); }));
+		checkAnswer(day.name + "/part2", aoc::profile("part2", [&] { return solver.part2(); }));
+	}
+
+	// A step whose answer changes between runs isn't measuring the same work
+	void checkAnswer(const std::string& name, const std::string& answer)
+	{
+		auto [it, inserted] = m_answers.try_emplace(name, answer);
+		if (!inserted && it->second != answer) {
+			throw std::runtime_error(name + " gave different answers between runs: "
+				+ it->second + " and " + answer);
+		}
+	}
+
+	const BenchOptions& m_options;
+	std::map<std::string, std::string> m_answers;
+};
+
+
+class Baseline
+{
+public:
+	using Medians = std::map<std::string, uint64_t>;
+
+	static Medians fromStats(const std::vector<aoc::Profiler::PhaseStats>& stats)
+	{
+		Medians medians;
+		for (const auto& phase : stats) {
+			medians[phase.name] = phase.medianNs;
+		}
+		return medians;
+	}
+
+	static Medians load(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file) {
+			throw std::runtime_error("Cannot open baseline: " + path);
+		}
+
+		Medians medians;
+		std::string name;
+		uint64_t medianNs;
+		while (file >> name >> medianNs) {
+			medians[name] = medianNs;
+		}
+		return medians;
+	}
+
+	static void save(const std::string& path, const Medians& medians)
+	{
+		std::ofstream file(path);
+		if (!file) {
+			throw std::runtime_error("Cannot write baseline: " + path);
+		}
+
+		for (const auto& [name, medianNs] : medians) {
+			file << name << " " << medianNs << "\n";
+		}
+	}
+};
+
+
+std::string formatMs(uint64_t ns)
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(3) << ns / 1e6;
+	return ss.str();
+}
+
+void printStats(std::ostream& out, const std::vector<aoc::Profiler::PhaseStats>& stats)
+{
+	out << std::left << std::setw(20) << "phase" << std::right
+		<< std::setw(6) << "runs"
+		<< std::setw(12) << "min ms"
+		<< std::setw(12) << "median ms"
+		<< std::setw(12) << "p99 ms"
+		<< std::setw(12) << "max ms"
+		<< "\n";
+
+	for (const auto& phase : stats) {
+		out << std::left << std::setw(20) << phase.name << std::right
+			<< std::setw(6) << phase.count
+			<< std::setw(12) << formatMs(phase.minNs)
+			<< std::setw(12) << formatMs(phase.medianNs)
+			<< std::setw(12) << formatMs(phase.p99Ns)
+			<< std::setw(12) << formatMs(phase.maxNs)
+			<< "\n";
+	}
+}
+
+// Per run averages, IPC and misses per thousand instructions
+void printCounters(std::ostream& out, const std::vector<aoc::Profiler::PhaseStats>& stats)
+{
+	using aoc::PerfCounters;
+	const aoc::Profiler& profiler = aoc::Profiler::instance();
+	if (std::none_of(stats.begin(), stats.end(), [](const auto& phase) { return phase.hasCounters; })) {
+		return;
+	}
+	auto column = [&](PerfCounters::Counter counter, double value, bool perInstruction = false) {
+		std::stringstream ss;
+		if (profiler.counterAvailable(counter)
+			&& (!perInstruction || profiler.counterAvailable(PerfCounters::INSTRUCTIONS))) {
+			ss << std::fixed << std::setprecision(2) << value;
+		}
+		else {
+			ss << "-";
+		}
+		return ss.str();
+	};
+
+	out << "\n" << std::left << std::setw(20) << "phase" << std::right
+		<< std::setw(14) << "Mcycles"
+		<< std::setw(14) << "Minstr"
+		<< std::setw(8) << "IPC"
+		<< std::setw(12) << "L1D MPKI"
+		<< std::setw(12) << "LLC MPKI"
+		<< std::setw(12) << "br MPKI"
+		<< "\n";
+
+	for (const auto& phase : stats) {
+		if (!phase.hasCounters) {
+			continue;
+		}
+
+		auto perRun = [&](PerfCounters::Counter counter) {
+			return static_cast<double>(phase.counters[counter]) / phase.count;
+		};
+		double instructions = static_cast<double>(phase.counters[PerfCounters::INSTRUCTIONS]);
+		auto perKiloInstr = [&](PerfCounters::Counter counter) {
+			return instructions == 0 ? 0.0 : phase.counters[counter] * 1000.0 / instructions;
+		};
+		double cycles = static_cast<double>(phase.counters[PerfCounters::CYCLES]);
+
+		out << std::left << std::setw(20) << phase.name << std::right
+			<< std::setw(14) << column(PerfCounters::CYCLES, perRun(PerfCounters::CYCLES) / 1e6)
+			<< std::setw(14) << column(PerfCounters::INSTRUCTIONS, perRun(PerfCounters::INSTRUCTIONS) / 1e6)
+			<< std::setw(8) << (cycles != 0 ? column(PerfCounters::CYCLES, instructions / cycles, true) : "-")
+			<< std::setw(12) << column(PerfCounters::L1D_MISSES, perKiloInstr(PerfCounters::L1D_MISSES), true)
+			<< std::setw(12) << column(PerfCounters::LLC_MISSES, perKiloInstr(PerfCounters::LLC_MISSES), true)
+			<< std::setw(12) << column(PerfCounters::BRANCH_MISSES, perKiloInstr(PerfCounters::BRANCH_MISSES), true)
+			<< "\n";
+	}
+}
+
+// Per run averages, peak is the highest of all runs
+void printAllocations(std::ostream& out, const std::vector<aoc::Profiler::PhaseStats>& stats)
+{
+	out << "\n" << std::left << std::setw(20) << "phase" << std::right
+		<< std::setw(14) << "allocs"
+		<< std::setw(14) << "KB"
+		<< std::setw(14) << "peak KB"
+		<< "\n";
+
+	for (const auto& phase : stats) {
+		out << std::left << std::setw(20) << phase.name << std::right
+			<< std::setw(14) << phase.allocations / phase.count
+			<< std::setw(14) << std::fixed << std::setprecision(1) << phase.allocatedBytes / 1024.0 / phase.count
+			<< std::setw(14) << phase.peakLiveBytes / 1024.0
+			<< "\n";
+	}
+}
+
+// Returns the number of phases slower than baseline by more than the threshold
+size_t compareWithBaseline(std::ostream& out, const Baseline::Medians& current,
+	const Baseline::Medians& baseline, double thresholdPercent)
+{
+	size_t regressions = 0;
+	out << "\nCompared with baseline (threshold " << thresholdPercent << "%):\n";
+	for (const auto& [name, medianNs] : current) {
+		auto it = baseline.find(name);
+		if (it == baseline.end() || it->second == 0) {
+			out << std::left << std::setw(20) << name << " no baseline\n";
+			continue;
+		}
+
+		double changePercent = (static_cast<double>(medianNs) / it->second - 1.0) * 100.0;
+		bool regressed = changePercent > thresholdPercent;
+		regressions += regressed;
+		out << std::left << std::setw(20) << name << std::right
+			<< std::setw(12) << formatMs(it->second) << " -> " << std::setw(12) << formatMs(medianNs)
+			<< "  " << std::showpos << std::fixed << std::setprecision(1) << std::setw(10) << changePercent << "%"
+			<< std::noshowpos << (regressed ? "  REGRESSION" : "")
+			<< "\n";
+	}
+	return regressions;
+}
+
+bool pinToCpu(int cpu)
+{
+#if defined(_WIN32)
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1 } << cpu) != 0;
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+	return false;
+#endif
+}
+
+int main(int argc, char* args[])
+{
+	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	if (std::find(runArgs.begin(), runArgs.end(), "--help") != runArgs.end()) {
+		BenchArgsParser::printUsage(std::cout);
+		return 0;
+	}
+
+	try {
+		aoc::consumeThreadsOption(runArgs);
+		BenchOptions options = BenchArgsParser().parse(runArgs);
+		if (options.targets.empty()) {
+			std::cerr << "No inputs found, nothing to benchmark." << std::endl;
+			return 1;
+		}
+
+		// Threads started by the solvers inherit the affinity, so parallel days run on one CPU
+		if (options.cpu >= 0 && !pinToCpu(options.cpu)) {
+			std::cerr << "Cannot pin to CPU " << options.cpu << ", running unpinned." << std::endl;
+		}
+
+		if (options.counters) {
+			aoc::Profiler::instance().setCountersEnabled(true);
+		}
+
+		Bench bench(options);
+		bench.run();
+		bench.printAnswers(std::cout);
+
+		auto stats = aoc::Profiler::instance().stats();
+		std::cout << "\n";
+		printStats(std::cout, stats);
+		if (options.counters) {
+			printCounters(std::cout, stats);
+		}
+		if (aoc::AllocationTracker::ENABLED) {
+			printAllocations(std::cout, stats);
+		}
+
+		Baseline::Medians medians = Baseline::fromStats(stats);
+		if (!options.saveBaselinePath.empty()) {
+			Baseline::save(options.saveBaselinePath, medians);
+		}
+
+		if (!options.baselinePath.empty()) {
+			size_t regressions = compareWithBaseline(std::cout, medians,
+				Baseline::load(options.baselinePath), options.thresholdPercent);
+			if (regressions > 0) {
+				std::cout << regressions << " phase(s) regressed." << std::endl;
+				return 2;
+			}
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,1136 @@
+#include <utils.hpp>
+#include <FlatHash.hpp>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <random>
+#include <charconv>
+#include <functional>
+#include <concepts>
+
+// Deterministic for a seed on every platform. Only the engine's output is
+// fixed by the standard, the std distributions differ between libraries,
+// so ranges are drawn by rejection here.
+class Random
+{
+public:
+	explicit Random(uint64_t seed)
+		: m_engine{ seed }
+	{}
+
+	// Uniform in [0, n), n must be positive
+	uint64_t below(uint64_t n)
+	{
+		uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+		uint64_t value;
+		do {
+			value = m_engine();
+		} while (value >= limit);
+		return value % n;
+	}
+
+	int64_t between(int64_t min, int64_t max)
+	{
+		return min + static_cast<int64_t>(below(static_cast<uint64_t>(max - min) + 1));
+	}
+
+	bool chance(double probability)
+	{
+		return static_cast<double>(m_engine() >> 11) * 0x1.0p-53 < probability;
+	}
+
+	char pick(std::string_view chars)
+	{
+		return chars[below(chars.size())];
+	}
+
+	// Calls onPick with count distinct values of [0, n) in random order. Only
+	// the swapped places of a virtual Fisher-Yates shuffle are stored.
+	template<typename OnPick>
+	void sample(uint64_t n, uint64_t count, OnPick&& onPick)
+	{
+		aoc::FlatMap<uint64_t, uint64_t> swapped;
+		auto valueAt = [&swapped](uint64_t idx) {
+			auto it = swapped.find(idx);
+			return it == swapped.end() ? idx : it->second;
+		};
+
+		count = std::min(count, n);
+		for (uint64_t i = 0; i < count; ++i) {
+			uint64_t j = i + below(n - i);
+			uint64_t picked = valueAt(j);
+			swapped[j] = valueAt(i);
+			onPick(picked);
+		}
+	}
+
+	template<typename T>
+	void shuffle(std::vector<T>& values)
+	{
+		for (size_t i = values.size(); i > 1; --i) {
+			std::swap(values[i - 1], values[below(i)]);
+		}
+	}
+
+private:
+	std::mt19937_64 m_engine;
+};
+
+
+// Buffers output, generated inputs can be gigabytes of short lines
+class Writer
+{
+public:
+	explicit Writer(std::ostream& out)
+		: m_out{ &out }
+	{
+		m_buffer.reserve(BUFFER_SIZE);
+	}
+
+	Writer(Writer&&) = default;
+
+	~Writer()
+	{
+		flush();
+	}
+
+	Writer& operator<<(std::string_view text)
+	{
+		m_buffer.append(text);
+		flushIfFull();
+		return *this;
+	}
+
+	Writer& operator<<(char c)
+	{
+		m_buffer.push_back(c);
+		flushIfFull();
+		return *this;
+	}
+
+	template<std::integral T>
+	Writer& operator<<(T value)
+	{
+		char digits[24];
+		auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+		return *this << std::string_view(digits, end - digits);
+	}
+
+	void flush()
+	{
+		if (m_out != nullptr && !m_buffer.empty()) {
+			m_out->write(m_buffer.data(), m_buffer.size());
+			m_buffer.clear();
+		}
+	}
+
+private:
+	static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+	void flushIfFull()
+	{
+		if (m_buffer.size() >= BUFFER_SIZE) {
+			flush();
+		}
+	}
+
+	std::ostream* m_out;
+	std::string m_buffer;
+};
+
+
+class GenParams
+{
+public:
+	explicit GenParams(std::map<std::string, std::string> values)
+		: m_values{ std::move(values) }
+	{}
+
+	template<typename T>
+	T get(const std::string& name) const
+	{
+		const std::string& text = m_values.at(name);
+		T result{};
+		auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), result);
+		if (ec != std::errc{} || ptr != text.data() + text.size()) {
+			throw std::invalid_argument("Invalid value of " + name + ": " + text);
+		}
+		return result;
+	}
+
+private:
+	std::map<std::string, std::string> m_values;
+};
+
+
+struct GenParam
+{
+	std::string name;
+	std::string defaultValue;
+	std::string help;
+};
+
+using GenerateFn = void(*)(const GenParams& params, Random& rng, std::vector<Writer>& files);
+
+struct Generator
+{
+	std::string day;
+	// One output file per suffix, Day 5 input is split into two
+	std::vector<std::string> fileSuffixes;
+	std::vector<GenParam> params;
+	GenerateFn generate;
+};
+
+
+// Perfect maze of cellsX x cellsY cells carved by a randomized depth first
+// search. In grid coordinates cell (x, y) is at (2x + 1, 2y + 1) and the
+// walls between cells are on the even rows and columns.
+class CarvedMaze
+{
+public:
+	CarvedMaze(size_t cellsX, size_t cellsY)
+		: m_cellsX{ cellsX }, m_cellsY{ cellsY },
+		m_openRight(cellsX * cellsY), m_openDown(cellsX * cellsY)
+	{}
+
+	// Returns the cells on the way from start to target, both included
+	std::vector<uint32_t> carve(Random& rng, uint32_t start, uint32_t target)
+	{
+		std::vector<bool> visited(m_cellsX * m_cellsY);
+		std::vector<uint32_t> stack{ start };
+		std::vector<uint32_t> pathToTarget;
+		visited[start] = true;
+		if (start == target) {
+			pathToTarget = stack;
+		}
+
+		while (!stack.empty()) {
+			uint32_t cell = stack.back();
+			uint32_t candidates[4];
+			size_t count = 0;
+			size_t x = cell % m_cellsX;
+			size_t y = cell / m_cellsX;
+			if (x > 0 && !visited[cell - 1]) candidates[count++] = cell - 1;
+			if (x + 1 < m_cellsX && !visited[cell + 1]) candidates[count++] = cell + 1;
+			if (y > 0 && !visited[cell - m_cellsX]) candidates[count++] = cell - m_cellsX;
+			if (y + 1 < m_cellsY && !visited[cell + m_cellsX]) candidates[count++] = cell + m_cellsX;
+
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+
+			uint32_t next = candidates[rng.below(count)];
+			open(cell, next);
+			visited[next] = true;
+			stack.push_back(next);
+			if (next == target) {
+				pathToTarget = stack;
+			}
+		}
+
+		return pathToTarget;
+	}
+
+	size_t gridSizeX() const { return 2 * m_cellsX + 1; }
+	size_t gridSizeY() const { return 2 * m_cellsY + 1; }
+	uint32_t cellAt(size_t x, size_t y) const { return static_cast<uint32_t>(y * m_cellsX + x); }
+
+	// Cells and passages are open, everything else is wall
+	bool isOpen(size_t gx, size_t gy) const
+	{
+		if (gx == 0 || gy == 0 || gx + 1 >= gridSizeX() || gy + 1 >= gridSizeY()) {
+			return false;
+		}
+
+		size_t x = (gx - 1) / 2;
+		size_t y = (gy - 1) / 2;
+		bool oddX = gx % 2 == 1;
+		bool oddY = gy % 2 == 1;
+		if (oddX && oddY) {
+			return true;
+		}
+		if (oddY) {
+			return m_openRight[cellAt(x, y)];
+		}
+		if (oddX) {
+			return m_openDown[cellAt(x, y)];
+		}
+		return false;
+	}
+
+	std::pair<size_t, size_t> gridPosition(uint32_t cell) const
+	{
+		return { 2 * (cell % m_cellsX) + 1, 2 * (cell / m_cellsX) + 1 };
+	}
+
+private:
+	void open(uint32_t a, uint32_t b)
+	{
+		uint32_t first = std::min(a, b);
+		uint32_t second = std::max(a, b);
+		if (second == first + 1) {
+			m_openRight[first] = true;
+		}
+		else {
+			m_openDown[first] = true;
+		}
+	}
+
+	size_t m_cellsX;
+	size_t m_cellsY;
+	std::vector<bool> m_openRight;
+	std::vector<bool> m_openDown;
+};
+
+
+size_t mazeCells(size_t gridSize)
+{
+	if (gridSize < 5) {
+		throw std::invalid_argument("Maze needs at least 5 fields per side");
+	}
+	return (gridSize - 1) / 2;
+}
+
+void writeGrid(Writer& out, size_t sizeX, size_t sizeY, const std::function<char(size_t, size_t)>& fieldAt)
+{
+	for (size_t y = 0; y < sizeY; ++y) {
+		for (size_t x = 0; x < sizeX; ++x) {
+			out << fieldAt(x, y);
+		}
+		out << '\n';
+	}
+}
+
+
+void generateDay01(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto max = params.get<int64_t>("max");
+	for (uint64_t i = 0; i < count; ++i) {
+		files[0] << rng.between(1, max) << "   " << rng.between(1, max) << '\n';
+	}
+}
+
+void generateDay02(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto maxLevels = params.get<int64_t>("max-levels");
+	auto faults = params.get<double>("faults");
+	for (uint64_t i = 0; i < count; ++i) {
+		int64_t levels = rng.between(5, std::max<int64_t>(5, maxLevels));
+		int64_t direction = rng.chance(0.5) ? 1 : -1;
+		// Far enough from zero that even faulty steps keep levels positive
+		int64_t level = rng.between(6 * levels, 6 * levels + 50);
+		for (int64_t l = 0; l < levels; ++l) {
+			files[0] << (l == 0 ? "" : " ") << level;
+			int64_t step = rng.between(1, 3);
+			if (rng.chance(faults)) {
+				step = rng.chance(0.5) ? rng.between(-3, 0) : rng.between(4, 5);
+			}
+			level += direction * step;
+		}
+		files[0] << '\n';
+	}
+}
+
+void generateDay03(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	static constexpr std::string_view noise = "mul()don't,;:?!@#$%^&*-+[]{}<>/'~ select what how from when where who why";
+	auto lines = params.get<uint64_t>("lines");
+	auto length = params.get<uint64_t>("length");
+	for (uint64_t i = 0; i < lines; ++i) {
+		for (uint64_t written = 0; written < length; ++written) {
+			uint64_t roll = rng.below(100);
+			if (roll < 5) {
+				files[0] << "mul(" << rng.between(0, 999) << ',' << rng.between(0, 999) << ')';
+			}
+			else if (roll < 6) {
+				files[0] << (rng.chance(0.5) ? "do()" : "don't()");
+			}
+			else if (roll < 7) {
+				// Almost an instruction, must be ignored
+				files[0] << "mul(" << rng.between(0, 999) << rng.pick(",] ") << rng.between(0, 999) << rng.pick(")[");
+			}
+			else {
+				files[0] << rng.pick(noise);
+			}
+		}
+		files[0] << '\n';
+	}
+}
+
+void generateDay04(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	writeGrid(files[0], params.get<size_t>("width"), params.get<size_t>("height"),
+		[&](size_t, size_t) { return rng.pick("XMAS"); });
+}
+
+void generateDay05(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto pages = params.get<uint64_t>("pages");
+	auto queues = params.get<uint64_t>("queues");
+	auto maxLength = std::min(params.get<uint64_t>("max-length"), pages);
+	if (pages < 3) {
+		throw std::invalid_argument("Day 5 needs at least 3 pages");
+	}
+
+	// Pages get a random order, there's a rule for every pair of them
+	std::vector<uint64_t> order(pages);
+	for (uint64_t i = 0; i < pages; ++i) {
+		order[i] = 10 + i;
+	}
+	rng.shuffle(order);
+
+	std::vector<std::pair<uint64_t, uint64_t>> rules;
+	for (uint64_t i = 0; i < pages; ++i) {
+		for (uint64_t j = i + 1; j < pages; ++j) {
+			rules.emplace_back(order[i], order[j]);
+		}
+	}
+	rng.shuffle(rules);
+	for (const auto& [before, after] : rules) {
+		files[0] << before << '|' << after << '\n';
+	}
+
+	std::vector<uint64_t> queue;
+	for (uint64_t i = 0; i < queues; ++i) {
+		uint64_t length = rng.between(1, static_cast<int64_t>((maxLength - 1) / 2)) * 2 + 1;
+		queue.clear();
+		rng.sample(pages, length, [&](uint64_t idx) { queue.push_back(idx); });
+		if (rng.chance(0.5)) {
+			std::sort(queue.begin(), queue.end());
+		}
+
+		for (size_t p = 0; p < queue.size(); ++p) {
+			files[1] << (p == 0 ? "" : ",") << order[queue[p]];
+		}
+		files[1] << '\n';
+	}
+}
+
+void generateDay06(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto width = params.get<uint64_t>("width");
+	auto height = params.get<uint64_t>("height");
+	auto obstacles = params.get<double>("obstacles");
+	uint64_t guard = rng.below(width * height);
+	writeGrid(files[0], width, height, [&](size_t x, size_t y) {
+		if (y * width + x == guard) {
+			return '^';
+		}
+		return rng.chance(obstacles) ? '#' : '.';
+	});
+}
+
+void generateDay07(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto maxElements = params.get<int64_t>("max-elements");
+	auto valid = params.get<double>("valid");
+	std::vector<uint64_t> elements;
+	for (uint64_t i = 0; i < count; ++i) {
+		elements.resize(rng.between(2, std::max<int64_t>(2, maxElements)));
+		for (auto& element : elements) {
+			element = rng.chance(0.6) ? rng.between(1, 9) : rng.between(10, 999);
+		}
+
+		// Result of random operations, an operation that could overflow is replaced by +
+		static constexpr uint64_t LIMIT = uint64_t{ 1 } << 60;
+		uint64_t result = elements.front();
+		for (size_t e = 1; e < elements.size(); ++e) {
+			uint64_t element = elements[e];
+			uint64_t shift = element < 10 ? 10 : element < 100 ? 100 : 1000;
+			uint64_t op = rng.below(3);
+			if (op == 1 && result < LIMIT / element) {
+				result *= element;
+			}
+			else if (op == 2 && result < LIMIT / shift) {
+				result = result * shift + element;
+			}
+			else {
+				result += element;
+			}
+		}
+		if (!rng.chance(valid)) {
+			result += rng.between(1, 10);
+		}
+
+		files[0] << result << ':';
+		for (uint64_t element : elements) {
+			files[0] << ' ' << element;
+		}
+		files[0] << '\n';
+	}
+}
+
+void generateDay08(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	static constexpr std::string_view allFrequencies = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	auto frequencies = std::clamp<size_t>(params.get<size_t>("frequencies"), 1, allFrequencies.size());
+	auto antennas = params.get<double>("antennas");
+	writeGrid(files[0], params.get<size_t>("width"), params.get<size_t>("height"), [&](size_t, size_t) {
+		return rng.chance(antennas) ? rng.pick(allFrequencies.substr(0, frequencies)) : '.';
+	});
+}
+
+void generateDay09(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto length = params.get<uint64_t>("length");
+	for (uint64_t i = 0; i < length; ++i) {
+		// Even places are files, which are never empty
+		files[0] << static_cast<char>('0' + (i % 2 == 0 ? rng.between(1, 9) : rng.between(0, 9)));
+	}
+	files[0] << '\n';
+}
+
+void generateDay10(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	// Diagonal slopes give long trails, noise breaks some of them
+	auto noise = params.get<double>("noise");
+	writeGrid(files[0], params.get<size_t>("width"), params.get<size_t>("height"), [&](size_t x, size_t y) {
+		return static_cast<char>('0' + (rng.chance(noise) ? rng.below(10) : (x + y) % 10));
+	});
+}
+
+void generateDay11(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto max = params.get<int64_t>("max");
+	for (uint64_t i = 0; i < count; ++i) {
+		files[0] << (i == 0 ? "" : " ") << rng.between(0, max);
+	}
+	files[0] << '\n';
+}
+
+void generateDay12(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	// Blocks of one plant, with ragged edges where a field takes a neighbour's plant
+	auto block = std::max<uint64_t>(1, params.get<uint64_t>("block"));
+	auto plants = std::clamp<uint64_t>(params.get<uint64_t>("plants"), 1, 26);
+	uint64_t seed = rng.below(UINT64_MAX);
+	auto plantOf = [&](int64_t bx, int64_t by) {
+		return static_cast<char>('A' + aoc::combineHash(aoc::mixHash(seed + bx), by) % plants);
+	};
+
+	writeGrid(files[0], params.get<size_t>("width"), params.get<size_t>("height"), [&](size_t x, size_t y) {
+		int64_t bx = x / block;
+		int64_t by = y / block;
+		if (rng.chance(0.15)) {
+			bx += rng.between(-1, 1);
+			by += rng.between(-1, 1);
+		}
+		return plantOf(bx, by);
+	});
+}
+
+void generateDay13(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	for (uint64_t i = 0; i < count; ++i) {
+		int64_t ax = rng.between(10, 99);
+		int64_t ay = rng.between(10, 99);
+		int64_t bx = rng.between(10, 99);
+		int64_t by = rng.between(10, 99);
+		int64_t pressA = rng.between(1, 100);
+		int64_t pressB = rng.between(1, 100);
+		int64_t prizeX = pressA * ax + pressB * bx + (rng.chance(0.5) ? rng.between(1, 50) : 0);
+		int64_t prizeY = pressA * ay + pressB * by + (rng.chance(0.5) ? rng.between(1, 50) : 0);
+
+		files[0] << (i == 0 ? "" : "\n")
+			<< "Button A: X+" << ax << ", Y+" << ay << '\n'
+			<< "Button B: X+" << bx << ", Y+" << by << '\n'
+			<< "Prize: X=" << prizeX << ", Y=" << prizeY << '\n';
+	}
+}
+
+void generateDay14(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto width = params.get<int64_t>("width");
+	auto height = params.get<int64_t>("height");
+	int64_t maxSpeed = std::min(width, height) - 1;
+	for (uint64_t i = 0; i < count; ++i) {
+		files[0] << "p=" << rng.between(0, width - 1) << ',' << rng.between(0, height - 1)
+			<< " v=" << rng.between(-maxSpeed, maxSpeed) << ',' << rng.between(-maxSpeed, maxSpeed) << '\n';
+	}
+}
+
+void generateDay15(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto width = params.get<uint64_t>("width");
+	auto height = params.get<uint64_t>("height");
+	auto boxes = params.get<double>("boxes");
+	auto walls = params.get<double>("walls");
+	auto moves = params.get<uint64_t>("moves");
+	writeGrid(files[0], width, height, [&](size_t x, size_t y) {
+		if (x == 0 || y == 0 || x + 1 == width || y + 1 == height) {
+			return '#';
+		}
+		if (x == width / 2 && y == height / 2) {
+			return '@';
+		}
+		if (rng.chance(walls)) {
+			return '#';
+		}
+		return rng.chance(boxes) ? 'O' : '.';
+	});
+
+	files[0] << '\n';
+	static constexpr uint64_t MOVES_PER_LINE = 1000;
+	for (uint64_t i = 0; i < moves; ++i) {
+		files[0] << rng.pick("<>^v");
+		if ((i + 1) % MOVES_PER_LINE == 0 || i + 1 == moves) {
+			files[0] << '\n';
+		}
+	}
+}
+
+void generateDay16(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	CarvedMaze maze(mazeCells(params.get<size_t>("width")), mazeCells(params.get<size_t>("height")));
+	uint32_t start = maze.cellAt(0, (maze.gridSizeY() - 1) / 2 - 1);
+	uint32_t end = maze.cellAt((maze.gridSizeX() - 1) / 2 - 1, 0);
+	maze.carve(rng, start, end);
+
+	// Removed walls make loops, so there are many paths to compare
+	auto loops = params.get<double>("loops");
+	auto [startX, startY] = maze.gridPosition(start);
+	auto [endX, endY] = maze.gridPosition(end);
+	writeGrid(files[0], maze.gridSizeX(), maze.gridSizeY(), [&](size_t x, size_t y) {
+		if (x == startX && y == startY) {
+			return 'S';
+		}
+		if (x == endX && y == endY) {
+			return 'E';
+		}
+		bool inside = x > 0 && y > 0 && x + 1 < maze.gridSizeX() && y + 1 < maze.gridSizeY();
+		bool passage = (x % 2) != (y % 2);
+		if (maze.isOpen(x, y) || (inside && passage && rng.chance(loops))) {
+			return '.';
+		}
+		return '#';
+	});
+}
+
+// Runs one of the generated programs, which all loop while A isn't zero
+std::vector<int> runProgram(const std::vector<int>& program, uint64_t regA)
+{
+	std::vector<int> printed;
+	uint64_t regs[3] = { regA, 0, 0 };
+	for (size_t ip = 0; ip + 1 < program.size(); ip += 2) {
+		uint64_t literal = program[ip + 1];
+		uint64_t combo = literal < 4 ? literal : regs[literal - 4];
+		switch (program[ip]) {
+		case 0: regs[0] = combo < 64 ? regs[0] >> combo : 0; break;
+		case 1: regs[1] ^= literal; break;
+		case 2: regs[1] = combo % 8; break;
+		case 3: if (regs[0] != 0) ip = literal - 2; break;
+		case 4: regs[1] ^= regs[2]; break;
+		case 5: printed.push_back(static_cast<int>(combo % 8)); break;
+		case 6: regs[1] = combo < 64 ? regs[0] >> combo : 0; break;
+		case 7: regs[2] = combo < 64 ? regs[0] >> combo : 0; break;
+		}
+	}
+	return printed;
+}
+
+// Same search as the solver, 3 bits of A per printed number from the last
+// one. The solver goes through the whole tree, so a program whose tree takes
+// more than maxSteps isn't accepted even with a value found.
+bool hasSelfPrintingValue(const std::vector<int>& program, size_t maxSteps)
+{
+	bool found = false;
+	std::vector<uint64_t> checked{ 0 };
+	for (size_t step = 0; !checked.empty(); ++step) {
+		if (step == maxSteps) {
+			return false;
+		}
+
+		uint64_t num = checked.back();
+		checked.pop_back();
+		for (uint64_t i = 0; i < 8; ++i) {
+			uint64_t regA = (num << 3) + i;
+			if (regA == 0) {
+				continue;
+			}
+			std::vector<int> printed = runProgram(program, regA);
+			if (printed.size() > program.size()
+				|| !std::equal(printed.begin(), printed.end(), program.end() - printed.size())) {
+				continue;
+			}
+			if (printed.size() == program.size()) {
+				found = true;
+			}
+			else {
+				checked.push_back(regA);
+			}
+		}
+	}
+	return found;
+}
+
+void generateDay17(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	// Same shape as the puzzle: B takes the low bits of A, C the bits of A above
+	// them, both are mixed into the printed B and A shifts by 3. Constants are
+	// drawn until the program has a self printing A, like the puzzle's has.
+	// A prints 3 bits at a time, so a self printing A fits in 64 bits only
+	// while the program has at most 21 numbers
+	auto length = params.get<uint64_t>("length");
+	if (length < 8 || length > 10) {
+		throw std::invalid_argument("Day 17 program length must be 8 to 10 instructions");
+	}
+	std::vector<int> program;
+	static constexpr size_t MAX_TRIES = 10000;
+	for (size_t tries = 0; tries < MAX_TRIES; ++tries) {
+		program = { 2, 4, 1, static_cast<int>(rng.below(8)), 7, 5 };
+		std::vector<std::pair<int, int>> mixing{ { 4, static_cast<int>(rng.below(8)) } };
+		for (uint64_t i = 8; i <= length; ++i) {
+			mixing.emplace_back(1, static_cast<int>(rng.below(8)));
+		}
+		rng.shuffle(mixing);
+		for (const auto& [opcode, operand] : mixing) {
+			program.push_back(opcode);
+			program.push_back(operand);
+		}
+		program.insert(program.end(), { 5, 5, 0, 3, 3, 0 });
+
+		if (hasSelfPrintingValue(program, 10000)) {
+			break;
+		}
+		if (tries + 1 == MAX_TRIES) {
+			throw std::runtime_error("No program with a self printing value found");
+		}
+	}
+
+	files[0] << "Register A: " << rng.below(uint64_t{ 1 } << 48) << '\n'
+		<< "Register B: 0\n"
+		<< "Register C: 0\n"
+		<< "\nProgram: ";
+	for (size_t i = 0; i < program.size(); ++i) {
+		files[0] << (i == 0 ? "" : ",") << program[i];
+	}
+	files[0] << '\n';
+}
+
+void generateDay18(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto width = params.get<uint64_t>("width");
+	auto height = params.get<uint64_t>("height");
+	auto count = params.get<uint64_t>("count");
+	// Start and exit stay free
+	uint64_t fields = width * height;
+	rng.sample(fields - 2, count, [&](uint64_t idx) {
+		uint64_t field = idx + 1;
+		files[0] << field % width << ',' << field / width << '\n';
+	});
+}
+
+void generateDay19(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	static constexpr std::string_view colors = "wubrg";
+	auto towelCount = params.get<uint64_t>("towels");
+	auto maxTowel = std::max<int64_t>(1, params.get<int64_t>("max-towel"));
+	auto patterns = params.get<uint64_t>("patterns");
+	auto maxPattern = std::max<int64_t>(1, params.get<int64_t>("max-pattern"));
+	auto possible = params.get<double>("possible");
+
+	aoc::FlatSet<std::string> unique;
+	std::vector<std::string> towels;
+	uint64_t attempts = 0;
+	while (towels.size() < towelCount && attempts++ < 100 * towelCount) {
+		// No towel starts with white, a pattern that does can't be made. The
+		// solver sees that right away, a pattern failing only at its end
+		// would make it try every way of making the rest.
+		std::string towel(1, rng.pick(colors.substr(1)));
+		for (int64_t l = rng.between(1, maxTowel); l > 1; --l) {
+			towel += rng.pick(colors);
+		}
+		if (unique.insert(towel).second) {
+			towels.push_back(std::move(towel));
+		}
+	}
+
+	for (size_t i = 0; i < towels.size(); ++i) {
+		files[0] << (i == 0 ? "" : ", ") << towels[i];
+	}
+	files[0] << "\n\n";
+
+	std::string pattern;
+	for (uint64_t i = 0; i < patterns; ++i) {
+		size_t length = rng.between(std::min<int64_t>(20, maxPattern), maxPattern);
+		pattern.clear();
+		bool fromTowels = rng.chance(possible);
+		while (pattern.size() < length) {
+			pattern += fromTowels ? towels[rng.below(towels.size())] : std::string(1, rng.pick(colors));
+		}
+		if (!fromTowels) {
+			pattern.front() = 'w';
+		}
+		files[0] << pattern << '\n';
+	}
+}
+
+void generateDay20(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	// The track is the way through a carved maze, all the rest is wall
+	CarvedMaze maze(mazeCells(params.get<size_t>("width")), mazeCells(params.get<size_t>("height")));
+	uint32_t start = maze.cellAt(0, (maze.gridSizeY() - 1) / 2 - 1);
+	uint32_t end = maze.cellAt((maze.gridSizeX() - 1) / 2 - 1, 0);
+	std::vector<uint32_t> path = maze.carve(rng, start, end);
+
+	size_t sizeX = maze.gridSizeX();
+	std::vector<bool> track(sizeX * maze.gridSizeY());
+	for (size_t i = 0; i < path.size(); ++i) {
+		auto [x, y] = maze.gridPosition(path[i]);
+		track[y * sizeX + x] = true;
+		if (i > 0) {
+			auto [prevX, prevY] = maze.gridPosition(path[i - 1]);
+			track[(y + prevY) / 2 * sizeX + (x + prevX) / 2] = true;
+		}
+	}
+
+	auto [startX, startY] = maze.gridPosition(start);
+	auto [endX, endY] = maze.gridPosition(end);
+	writeGrid(files[0], sizeX, maze.gridSizeY(), [&](size_t x, size_t y) {
+		if (x == startX && y == startY) {
+			return 'S';
+		}
+		if (x == endX && y == endY) {
+			return 'E';
+		}
+		return track[y * sizeX + x] ? '.' : '#';
+	});
+}
+
+void generateDay22(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	for (uint64_t i = 0; i < count; ++i) {
+		files[0] << rng.between(1, 16777215) << '\n';
+	}
+}
+
+void generateDay23(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto nodes = std::max<uint64_t>(2, params.get<uint64_t>("nodes"));
+	auto degree = params.get<double>("degree");
+	auto clique = std::min(params.get<uint64_t>("clique"), nodes);
+
+	// Names are as short as the node count allows, but never shorter than the puzzle's
+	size_t nameLength = 2;
+	for (uint64_t names = 26 * 26; names < nodes; names *= 26) {
+		++nameLength;
+	}
+	auto name = [nameLength](uint64_t node) {
+		std::string result(nameLength, 'a');
+		for (size_t i = nameLength; i-- > 0; node /= 26) {
+			result[i] = static_cast<char>('a' + node % 26);
+		}
+		return result;
+	};
+
+	aoc::FlatSet<uint64_t> edges;
+	auto connect = [&](uint64_t a, uint64_t b) {
+		if (a == b || !edges.insert(std::min(a, b) * nodes + std::max(a, b)).second) {
+			return;
+		}
+		files[0] << name(a) << '-' << name(b) << '\n';
+	};
+
+	// Planted clique, the rest of the edges are random
+	std::vector<uint64_t> members;
+	rng.sample(nodes, clique, [&](uint64_t node) { members.push_back(node); });
+	for (size_t i = 0; i < members.size(); ++i) {
+		for (size_t j = i + 1; j < members.size(); ++j) {
+			connect(members[i], members[j]);
+		}
+	}
+
+	auto edgeCount = static_cast<uint64_t>(nodes * degree / 2);
+	for (uint64_t i = 0; i < edgeCount; ++i) {
+		connect(rng.below(nodes), rng.below(nodes));
+	}
+}
+
+void generateDay25(const GenParams& params, Random& rng, std::vector<Writer>& files)
+{
+	auto count = params.get<uint64_t>("count");
+	auto width = params.get<int64_t>("width");
+	auto height = std::max<int64_t>(3, params.get<int64_t>("height"));
+	std::vector<int64_t> pins(width);
+	for (uint64_t i = 0; i < count; ++i) {
+		for (auto& pin : pins) {
+			pin = rng.between(0, height - 2);
+		}
+
+		// Locks hang from a full top row, keys stand on a full bottom row
+		bool isLock = rng.chance(0.5);
+		files[0] << (i == 0 ? "" : "\n");
+		for (int64_t y = 0; y < height; ++y) {
+			for (int64_t pin : pins) {
+				bool solid = isLock ? y <= pin : y >= height - 1 - pin;
+				files[0] << (y == 0 ? (isLock ? '#' : '.') : y == height - 1 ? (isLock ? '.' : '#') : solid ? '#' : '.');
+			}
+			files[0] << '\n';
+		}
+	}
+}
+
+
+const std::vector<Generator>& allGenerators()
+{
+	static const std::vector<Generator> generators{
+		{ "Day_01", { "" }, {
+			{ "count", "1000", "pairs of numbers" },
+			{ "max", "99999", "largest number" } }, &generateDay01 },
+		{ "Day_02", { "" }, {
+			{ "count", "1000", "reports" },
+			{ "max-levels", "8", "most levels of a report, at least 5" },
+			{ "faults", "0.05", "chance of a step being unsafe" } }, &generateDay02 },
+		{ "Day_03", { "" }, {
+			{ "lines", "6", "lines of memory" },
+			{ "length", "3300", "tokens per line" } }, &generateDay03 },
+		{ "Day_04", { "" }, {
+			{ "width", "140", "letters per row" },
+			{ "height", "140", "rows" } }, &generateDay04 },
+		{ "Day_05", { "Rules", "Queues" }, {
+			{ "pages", "49", "different pages, a rule is made for every pair" },
+			{ "queues", "200", "page queues" },
+			{ "max-length", "23", "most pages in a queue" } }, &generateDay05 },
+		{ "Day_06", { "" }, {
+			{ "width", "130", "fields per row" },
+			{ "height", "130", "rows" },
+			{ "obstacles", "0.012", "chance of a field being an obstacle" } }, &generateDay06 },
+		{ "Day_07", { "" }, {
+			{ "count", "850", "equations" },
+			{ "max-elements", "12", "most numbers of an equation" },
+			{ "valid", "0.5", "chance of an equation being solvable" } }, &generateDay07 },
+		{ "Day_08", { "" }, {
+			{ "width", "50", "fields per row" },
+			{ "height", "50", "rows" },
+			{ "antennas", "0.08", "chance of a field holding an antenna" },
+			{ "frequencies", "36", "different antenna frequencies, at most 62" } }, &generateDay08 },
+		{ "Day_09", { "" }, {
+			{ "length", "19999", "digits of the disk map" } }, &generateDay09 },
+		{ "Day_10", { "" }, {
+			{ "width", "45", "fields per row" },
+			{ "height", "45", "rows" },
+			{ "noise", "0.3", "chance of a field having a random height" } }, &generateDay10 },
+		{ "Day_11", { "" }, {
+			{ "count", "8", "stones" },
+			{ "max", "9999999", "largest number on a stone" } }, &generateDay11 },
+		{ "Day_12", { "" }, {
+			{ "width", "140", "fields per row" },
+			{ "height", "140", "rows" },
+			{ "block", "6", "size of areas before their edges are roughened" },
+			{ "plants", "26", "different plants, at most 26" } }, &generateDay12 },
+		{ "Day_13", { "" }, {
+			{ "count", "320", "claw machines" } }, &generateDay13 },
+		{ "Day_14", { "" }, {
+			{ "count", "500", "robots" },
+			{ "width", "101", "width of the room, the solver assumes 101" },
+			{ "height", "103", "height of the room, the solver assumes 103" } }, &generateDay14 },
+		{ "Day_15", { "" }, {
+			{ "width", "50", "fields per row" },
+			{ "height", "50", "rows" },
+			{ "boxes", "0.3", "chance of a field holding a box" },
+			{ "walls", "0.05", "chance of a field being a wall" },
+			{ "moves", "20000", "robot moves" } }, &generateDay15 },
+		{ "Day_16", { "" }, {
+			{ "width", "141", "fields per row" },
+			{ "height", "141", "rows" },
+			{ "loops", "0.03", "chance of a wall between fields being removed" } }, &generateDay16 },
+		{ "Day_17", { "" }, {
+			{ "length", "8", "instructions of the program, 8 to 10" } }, &generateDay17 },
+		{ "Day_18", { "" }, {
+			{ "width", "71", "width of the memory, the solver assumes 71" },
+			{ "height", "71", "height of the memory, the solver assumes 71" },
+			{ "count", "3450", "falling bytes, all at different places" } }, &generateDay18 },
+		{ "Day_19", { "" }, {
+			{ "towels", "447", "different towels" },
+			{ "max-towel", "8", "longest towel" },
+			{ "patterns", "400", "patterns to make" },
+			{ "max-pattern", "60", "longest pattern" },
+			{ "possible", "0.7", "chance of a pattern being made of towels" } }, &generateDay19 },
+		{ "Day_20", { "" }, {
+			{ "width", "141", "fields per row" },
+			{ "height", "141", "rows" } }, &generateDay20 },
+		{ "Day_22", { "" }, {
+			{ "count", "2000", "buyers' initial secret numbers" } }, &generateDay22 },
+		{ "Day_23", { "" }, {
+			{ "nodes", "520", "computers" },
+			{ "degree", "13", "average connections of a computer" },
+			{ "clique", "13", "size of a planted group of connected computers" } }, &generateDay23 },
+		{ "Day_25", { "" }, {
+			{ "count", "500", "keys and locks" },
+			{ "width", "5", "pins of a key or lock" },
+			{ "height", "7", "rows of a key or lock" } }, &generateDay25 },
+	};
+	return generators;
+}
+
+
+struct GenOptions
+{
+	const Generator* generator = nullptr;
+	std::map<std::string, std::string> params;
+	uint64_t seed = 2024;
+	std::string outPath;
+};
+
+class GenArgsParser
+{
+public:
+	GenOptions parse(const std::vector<std::string>& args) const
+	{
+		GenOptions options;
+		for (size_t i = 0; i < args.size(); ++i) {
+			const std::string& arg = args[i];
+			if (arg == "--seed") {
+				options.seed = parseSeed(value(args, i));
+			}
+			else if (arg == "--out") {
+				options.outPath = value(args, i);
+			}
+			else if (arg.starts_with("--")) {
+				throw std::invalid_argument("Unknown option: " + arg);
+			}
+			else if (options.generator == nullptr) {
+				options.generator = &findGenerator(arg);
+				for (const GenParam& param : options.generator->params) {
+					options.params[param.name] = param.defaultValue;
+				}
+			}
+			else {
+				setParam(options, arg);
+			}
+		}
+
+		if (options.generator == nullptr) {
+			throw std::invalid_argument("No day given");
+		}
+		if (options.generator->fileSuffixes.size() > 1 && options.outPath.empty()) {
+			throw std::invalid_argument(options.generator->day + " writes several files, --out is needed");
+		}
+		return options;
+	}
+
+	static void printUsage(std::ostream& out)
+	{
+		out << "Usage: aoc_gen DAY [name=value]... [--seed N] [--out FILE]\n"
+			<< "  DAY         day number or Day_XX name\n"
+			<< "  name=value  size of the input, see below\n"
+			<< "  --seed N    seed of the generator, the same seed gives the same input (2024)\n"
+			<< "  --out FILE  file to write instead of stdout, days with several input\n"
+			<< "              files get the part names inserted before the extension\n"
+			<< "\nParameters and their defaults:\n";
+		for (const Generator& generator : allGenerators()) {
+			out << generator.day << "\n";
+			for (const GenParam& param : generator.params) {
+				std::string assignment = param.name + "=" + param.defaultValue;
+				out << "  " << assignment << std::string(std::max<size_t>(24 - assignment.size(), 1), ' ')
+					<< param.help << "\n";
+			}
+		}
+	}
+
+private:
+	const std::string& value(const std::vector<std::string>& args, size_t& i) const
+	{
+		if (i + 1 >= args.size()) {
+			throw std::invalid_argument("Missing value for " + args[i]);
+		}
+		return args[++i];
+	}
+
+	uint64_t parseSeed(const std::string& text) const
+	{
+		uint64_t seed{};
+		auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), seed);
+		if (ec != std::errc{} || ptr != text.data() + text.size()) {
+			throw std::invalid_argument("Invalid value for --seed: " + text);
+		}
+		return seed;
+	}
+
+	const Generator& findGenerator(std::string dayName) const
+	{
+		if (!dayName.starts_with("Day_")) {
+			dayName = std::string(dayName.size() < 2 ? "Day_0" : "Day_") + dayName;
+		}
+
+		auto it = std::find_if(allGenerators().begin(), allGenerators().end(),
+			[&](const Generator& generator) { return generator.day == dayName; });
+		if (it == allGenerators().end()) {
+			throw std::invalid_argument("No generator for: " + dayName);
+		}
+		return *it;
+	}
+
+	void setParam(GenOptions& options, const std::string& arg) const
+	{
+		size_t eqPos = arg.find('=');
+		std::string name = arg.substr(0, eqPos);
+		if (eqPos == std::string::npos || !options.params.contains(name)) {
+			throw std::invalid_argument("Unknown parameter of " + options.generator->day + ": " + arg);
+		}
+		options.params[name] = arg.substr(eqPos + 1);
+	}
+};
+
+
+std::string outputPath(const std::string& path, const std::string& suffix)
+{
+	size_t dotPos = path.find_last_of('.');
+	size_t slashPos = path.find_last_of("/\\");
+	if (dotPos == std::string::npos || (slashPos != std::string::npos && dotPos < slashPos)) {
+		return path + suffix;
+	}
+	return path.substr(0, dotPos) + suffix + path.substr(dotPos);
+}
+
+int main(int argc, char* args[])
+{
+	auto runArgs = aoc::argsToString(argc - 1, args + 1);
+	if (runArgs.empty() || std::find(runArgs.begin(), runArgs.end(), "--help") != runArgs.end()) {
+		GenArgsParser::printUsage(std::cout);
+		return runArgs.empty() ? 1 : 0;
+	}
+
+	try {
+		GenOptions options = GenArgsParser().parse(runArgs);
+		const Generator& generator = *options.generator;
+
+		std::vector<std::ofstream> streams;
+		std::vector<Writer> files;
+		for (const std::string& suffix : generator.fileSuffixes) {
+			if (options.outPath.empty()) {
+				files.emplace_back(std::cout);
+				continue;
+			}
+
+			std::string path = outputPath(options.outPath, suffix);
+			streams.emplace_back(path, std::ios::binary);
+			if (!streams.back()) {
+				throw std::runtime_error("Cannot open file: " + path);
+			}
+		}
+		for (std::ofstream& stream : streams) {
+			files.emplace_back(stream);
+		}
+
+		Random rng(options.seed);
+		generator.generate(GenParams(options.params), rng, files);
+		for (Writer& file : files) {
+			file.flush();
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
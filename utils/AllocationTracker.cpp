@@ -0,0 +1,143 @@
+#include "AllocationTracker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+namespace aoc {
+#if defined(AOC_TRACK_ALLOCATIONS)
+	namespace {
+		// Plain data only, so touching it from operator new never allocates
+		constinit thread_local AllocationCounts threadCounts{};
+
+		// Every block starts with its size, the user part follows at an offset
+		// keeping the requested alignment
+		constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+		void* trackedAllocate(size_t size, size_t alignment) noexcept
+		{
+			size_t offset = std::max(HEADER_SIZE, alignment);
+			void* block = nullptr;
+			if (alignment <= HEADER_SIZE) {
+				block = std::malloc(offset + size);
+			}
+			else {
+				// aligned_alloc wants the size to be a multiple of the alignment
+				size_t total = (offset + size + alignment - 1) / alignment * alignment;
+				block = std::aligned_alloc(alignment, total);
+			}
+			if (block == nullptr) {
+				return nullptr;
+			}
+
+			std::byte* user = static_cast<std::byte*>(block) + offset;
+			*reinterpret_cast<size_t*>(user - sizeof(size_t)) = size;
+
+			AllocationCounts& counts = threadCounts;
+			++counts.allocations;
+			counts.bytes += size;
+			counts.liveBytes += size;
+			counts.peakLiveBytes = std::max(counts.peakLiveBytes, counts.liveBytes);
+			return user;
+		}
+
+		void trackedFree(void* ptr, size_t alignment) noexcept
+		{
+			if (ptr == nullptr) {
+				return;
+			}
+
+			std::byte* user = static_cast<std::byte*>(ptr);
+			size_t size = *reinterpret_cast<size_t*>(user - sizeof(size_t));
+			AllocationCounts& counts = threadCounts;
+			counts.liveBytes -= std::min(size, counts.liveBytes);
+			std::free(user - std::max(HEADER_SIZE, alignment));
+		}
+
+		void* allocateOrThrow(size_t size, size_t alignment)
+		{
+			size = std::max<size_t>(size, 1);
+			while (true) {
+				if (void* ptr = trackedAllocate(size, alignment)) {
+					return ptr;
+				}
+
+				std::new_handler handler = std::get_new_handler();
+				if (handler == nullptr) {
+					throw std::bad_alloc();
+				}
+				handler();
+			}
+		}
+
+		void* allocateOrNull(size_t size, size_t alignment) noexcept
+		{
+			try {
+				return allocateOrThrow(size, alignment);
+			}
+			catch (...) {
+				return nullptr;
+			}
+		}
+	}
+
+	AllocationCounts AllocationTracker::current()
+	{
+		return threadCounts;
+	}
+
+	uint64_t AllocationTracker::restartPeak()
+	{
+		uint64_t outerPeak = threadCounts.peakLiveBytes;
+		threadCounts.peakLiveBytes = threadCounts.liveBytes;
+		return outerPeak;
+	}
+
+	void AllocationTracker::endPeak(uint64_t outerPeak)
+	{
+		threadCounts.peakLiveBytes = std::max(threadCounts.peakLiveBytes, outerPeak);
+	}
+#else
+	AllocationCounts AllocationTracker::current()
+	{
+		return {};
+	}
+
+	uint64_t AllocationTracker::restartPeak()
+	{
+		return 0;
+	}
+
+	void AllocationTracker::endPeak(uint64_t)
+	{}
+#endif
+}
+
+
+#if defined(AOC_TRACK_ALLOCATIONS)
+namespace {
+	constexpr size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+void* operator new(size_t size) { return aoc::allocateOrThrow(size, DEFAULT_ALIGNMENT); }
+void* operator new[](size_t size) { return aoc::allocateOrThrow(size, DEFAULT_ALIGNMENT); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return aoc::allocateOrNull(size, DEFAULT_ALIGNMENT); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return aoc::allocateOrNull(size, DEFAULT_ALIGNMENT); }
+void* operator new(size_t size, std::align_val_t al) { return aoc::allocateOrThrow(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return aoc::allocateOrThrow(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return aoc::allocateOrNull(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return aoc::allocateOrNull(size, static_cast<size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete[](void* ptr) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete(void* ptr, size_t) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete[](void* ptr, size_t) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { aoc::trackedFree(ptr, DEFAULT_ALIGNMENT); }
+void operator delete(void* ptr, std::align_val_t al) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, size_t, std::align_val_t al) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, size_t, std::align_val_t al) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+void operator delete(void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+void operator delete[](void* ptr, std::align_val_t al, const std::nothrow_t&) noexcept { aoc::trackedFree(ptr, static_cast<size_t>(al)); }
+#endif
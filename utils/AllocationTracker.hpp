@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+namespace aoc {
+	// Counts of the global operator new/delete, which AllocationTracker.cpp
+	// replaces when built with AOC_TRACK_ALLOCATIONS (cmake -DAOC_TRACK_ALLOCATIONS=ON).
+	// Everything is counted per thread, so a phase doesn't see what pool
+	// workers allocate for it, and memory freed by another thread than the one
+	// allocating it stays live on the allocating one.
+	struct AllocationCounts
+	{
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+		uint64_t liveBytes = 0;
+		// Highest liveBytes since the last restartPeak
+		uint64_t peakLiveBytes = 0;
+	};
+
+	class AllocationTracker
+	{
+	public:
+#if defined(AOC_TRACK_ALLOCATIONS)
+		static constexpr bool ENABLED = true;
+#else
+		static constexpr bool ENABLED = false;
+#endif
+
+		// Counts of the calling thread, all zero without tracking
+		static AllocationCounts current();
+
+		// Starts a new peak at the current live bytes and returns the old peak.
+		// Nested measurements pass it back to endPeak, so the outer one still
+		// sees the highest value of the inner ones.
+		static uint64_t restartPeak();
+		static void endPeak(uint64_t outerPeak);
+	};
+}
@@ -0,0 +1,72 @@
+#include "Arena.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace aoc {
+	Arena::Arena(size_t chunkSize, std::pmr::memory_resource* upstream)
+		: m_upstream{ upstream }, m_nextChunkSize{ std::max<size_t>(chunkSize, alignof(std::max_align_t)) }
+	{}
+
+	Arena::~Arena()
+	{
+		releaseChunks();
+	}
+
+	void Arena::reset()
+	{
+		if (m_chunks.size() > 1) {
+			size_t totalSize = 0;
+			for (const Chunk& chunk : m_chunks) {
+				totalSize += chunk.size;
+			}
+			releaseChunks();
+			addChunk(totalSize);
+		}
+
+		if (!m_chunks.empty()) {
+			m_current = m_chunks.front().data;
+			m_end = m_current + m_chunks.front().size;
+		}
+		m_allocationCount = 0;
+		m_bytesAllocated = 0;
+	}
+
+	void* Arena::do_allocate(size_t bytes, size_t alignment)
+	{
+		void* ptr = m_current;
+		size_t space = m_end - m_current;
+		if (m_current == nullptr || !std::align(alignment, bytes, ptr, space)) {
+			// Chunks start max_align_t aligned, extra room covers stricter alignments
+			addChunk(std::max(m_nextChunkSize, bytes + alignment));
+			ptr = m_current;
+			space = m_end - m_current;
+			std::align(alignment, bytes, ptr, space);
+		}
+
+		m_current = static_cast<std::byte*>(ptr) + bytes;
+		++m_allocationCount;
+		m_bytesAllocated += bytes;
+		return ptr;
+	}
+
+	void Arena::addChunk(size_t size)
+	{
+		auto* data = static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+		m_chunks.push_back({ data, size });
+		++m_upstreamAllocationCount;
+
+		m_current = data;
+		m_end = data + size;
+		m_nextChunkSize = std::max(m_nextChunkSize, size * 2);
+	}
+
+	void Arena::releaseChunks()
+	{
+		for (const Chunk& chunk : m_chunks) {
+			m_upstream->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+		}
+		m_chunks.clear();
+		m_current = nullptr;
+		m_end = nullptr;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+namespace aoc {
+	// Monotonic memory resource for everything one solve allocates. Allocating
+	// bumps a pointer in the current chunk and deallocating does nothing, so
+	// a whole file's containers cost a few upstream calls. reset() takes all the
+	// memory back at once and keeps it for the next input. Not thread safe.
+	class Arena : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+		~Arena() override;
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		// Invalidates everything allocated so far. Chunks are merged into one
+		// big enough for the whole previous run, so a similar run fits in it.
+		void reset();
+
+		// Both count since the last reset
+		size_t allocationCount() const { return m_allocationCount; }
+		size_t bytesAllocated() const { return m_bytesAllocated; }
+		// Counts over the arena's lifetime
+		size_t upstreamAllocationCount() const { return m_upstreamAllocationCount; }
+
+	private:
+		struct Chunk
+		{
+			std::byte* data;
+			size_t size;
+		};
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void*, size_t, size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		void addChunk(size_t size);
+		void releaseChunks();
+
+		std::pmr::memory_resource* m_upstream;
+		std::vector<Chunk> m_chunks;
+		size_t m_nextChunkSize;
+		std::byte* m_current = nullptr;
+		std::byte* m_end = nullptr;
+
+		size_t m_allocationCount = 0;
+		size_t m_bytesAllocated = 0;
+		size_t m_upstreamAllocationCount = 0;
+	};
+}
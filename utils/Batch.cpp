@@ -0,0 +1,95 @@
+#include "Batch.hpp"
+#include "MappedInput.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+namespace aoc {
+	void expandManifests(std::vector<std::string>& args)
+	{
+		static const std::string option = "--manifest";
+		std::vector<std::string> expanded;
+		for (size_t i = 0; i < args.size(); ++i) {
+			std::string value;
+			if (args[i] == option) {
+				if (i + 1 >= args.size()) {
+					throw std::invalid_argument("Missing value for " + option);
+				}
+				value = args[++i];
+			}
+			else if (args[i].starts_with(option + "=")) {
+				value = args[i].substr(option.size() + 1);
+			}
+			else {
+				expanded.push_back(std::move(args[i]));
+				continue;
+			}
+
+			const std::filesystem::path manifestPath = value;
+			const std::filesystem::path manifestDir = manifestPath.parent_path();
+			MappedInput manifest(manifestPath.string());
+			size_t inputCount = 0;
+			for (std::string_view line : manifest) {
+				size_t first = line.find_first_not_of(" \t");
+				if (first == std::string_view::npos || line[first] == '#') {
+					continue;
+				}
+				line = line.substr(first, line.find_last_not_of(" \t") - first + 1);
+
+				std::filesystem::path input{ line };
+				expanded.push_back(input.is_relative() ? (manifestDir / input).string() : input.string());
+				++inputCount;
+			}
+
+			// Running nothing, or the default input, would hide the mistake
+			if (inputCount == 0) {
+				throw std::invalid_argument("Manifest " + value + " lists no inputs");
+			}
+		}
+
+		args = std::move(expanded);
+	}
+
+
+	std::unique_ptr<Arena> ArenaPool::acquire()
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_free.empty()) {
+			return std::make_unique<Arena>();
+		}
+
+		std::unique_ptr<Arena> arena = std::move(m_free.back());
+		m_free.pop_back();
+		return arena;
+	}
+
+	void ArenaPool::release(std::unique_ptr<Arena> arena)
+	{
+		arena->reset();
+		std::lock_guard lock(m_mutex);
+		m_free.push_back(std::move(arena));
+	}
+
+
+	OrderedOutput::OrderedOutput(size_t jobCount, std::ostream& out, std::ostream& err)
+		: m_results(jobCount), m_out{ out }, m_err{ err }
+	{}
+
+	void OrderedOutput::finish(size_t jobIdx, std::string out, std::string err)
+	{
+		std::lock_guard lock(m_mutex);
+		m_results[jobIdx] = { true, std::move(out), std::move(err) };
+
+		while (m_nextToWrite < m_results.size() && m_results[m_nextToWrite].done) {
+			Result& result = m_results[m_nextToWrite++];
+			if (!result.out.empty()) {
+				m_out.write(result.out.data(), result.out.size());
+				m_out.flush();
+			}
+			if (!result.err.empty()) {
+				m_err.write(result.err.data(), result.err.size());
+				m_err.flush();
+			}
+			result = {};
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <ostream>
+#include <mutex>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include "ThreadPool.hpp"
+#include "Arena.hpp"
+
+namespace aoc {
+	// Replaces every "--manifest FILE" or "--manifest=FILE" with the inputs FILE
+	// lists, one per line. Empty lines and lines starting with '#' are skipped,
+	// relative paths are taken from the manifest's directory. A manifest
+	// without any input is an error.
+	void expandManifests(std::vector<std::string>& args);
+
+
+	// Writes outputs of batch jobs in the order of their inputs, each one as
+	// soon as all the jobs before it are done
+	class OrderedOutput
+	{
+	public:
+		OrderedOutput(size_t jobCount, std::ostream& out, std::ostream& err);
+
+		void finish(size_t jobIdx, std::string out, std::string err);
+
+	private:
+		struct Result
+		{
+			bool done = false;
+			std::string out;
+			std::string err;
+		};
+
+		std::mutex m_mutex;
+		std::vector<Result> m_results;
+		size_t m_nextToWrite = 0;
+		std::ostream& m_out;
+		std::ostream& m_err;
+	};
+
+
+	// Arenas of finished jobs, reset and handed to the next ones, so a batch
+	// needs at most one per thread however many inputs it has
+	class ArenaPool
+	{
+	public:
+		std::unique_ptr<Arena> acquire();
+		void release(std::unique_ptr<Arena> arena);
+
+	private:
+		std::mutex m_mutex;
+		std::vector<std::unique_ptr<Arena>> m_free;
+	};
+
+
+	// Runs job(input, out) for every input on the shared pool. Whatever a job
+	// writes to out reaches the real stream in one write, in input order.
+	// An exception ends only its own job, its message goes to err.
+	// A job taking job(input, out, arena) gets an arena for the input's data,
+	// reset as soon as the job returns.
+	template<typename Input, typename Job>
+	void runBatch(const std::vector<Input>& inputs, Job&& job,
+		std::ostream& out = std::cout, std::ostream& err = std::cerr)
+	{
+		OrderedOutput output(inputs.size(), out, err);
+		ArenaPool arenas;
+		parallelFor(0, inputs.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				std::ostringstream jobOut;
+				std::string jobErr;
+				try {
+					if constexpr (std::is_invocable_v<Job&, const Input&, std::ostream&, Arena&>) {
+						std::unique_ptr<Arena> arena = arenas.acquire();
+						job(inputs[i], jobOut, *arena);
+						arenas.release(std::move(arena));
+					}
+					else {
+						job(inputs[i], jobOut);
+					}
+				}
+				catch (std::exception& e) {
+					jobErr = std::string(e.what()) + "\n";
+				}
+				output.finish(i, std::move(jobOut).str(), std::move(jobErr));
+			}
+		});
+	}
+}
@@ -0,0 +1,248 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include "utils.hpp"
+
+namespace aoc {
+	// Set of grid cells, one bit per cell and every row in whole 64-bit words.
+	// Bits past sizeX in the last word of a row are always zero, so counting
+	// is a popcount per word and whole-grid operations go word by word in
+	// plain loops the compiler vectorizes. Shifts move every cell one step,
+	// with AND/OR they make word-parallel stencils like floodFill.
+	class BitGrid
+	{
+	public:
+		using Word = uint64_t;
+		static constexpr size_t WORD_BITS = 64;
+
+		BitGrid() = default;
+
+		BitGrid(size_t sizeX, size_t sizeY)
+			: m_sizeX{ sizeX }, m_sizeY{ sizeY },
+			m_rowWords{ (sizeX + WORD_BITS - 1) / WORD_BITS },
+			m_words(m_rowWords * sizeY)
+		{}
+
+		size_t sizeX() const { return m_sizeX; }
+		size_t sizeY() const { return m_sizeY; }
+		size_t rowWords() const { return m_rowWords; }
+
+		bool contains(const Position& p) const
+		{
+			return p.x >= 0 && p.x < (int64_t)m_sizeX && p.y >= 0 && p.y < (int64_t)m_sizeY;
+		}
+
+		bool test(size_t x, size_t y) const
+		{
+			return (m_words[wordIndex(x, y)] >> (x % WORD_BITS)) & 1;
+		}
+
+		bool test(const Position& p) const { return test(p.x, p.y); }
+
+		void set(size_t x, size_t y)
+		{
+			m_words[wordIndex(x, y)] |= bit(x);
+		}
+
+		void set(const Position& p) { set(p.x, p.y); }
+
+		void reset(size_t x, size_t y)
+		{
+			m_words[wordIndex(x, y)] &= ~bit(x);
+		}
+
+		void reset(const Position& p) { reset(p.x, p.y); }
+
+		// Sets the cell and tells whether it was set before
+		bool testAndSet(size_t x, size_t y)
+		{
+			Word& word = m_words[wordIndex(x, y)];
+			bool wasSet = (word & bit(x)) != 0;
+			word |= bit(x);
+			return wasSet;
+		}
+
+		void clear()
+		{
+			std::fill(m_words.begin(), m_words.end(), Word{});
+		}
+
+		size_t count() const
+		{
+			size_t result = 0;
+			for (Word word : m_words) {
+				result += std::popcount(word);
+			}
+			return result;
+		}
+
+		bool any() const
+		{
+			return std::any_of(m_words.begin(), m_words.end(), [](Word word) { return word != 0; });
+		}
+
+		// Calls fn(x, y) for every set cell, row by row
+		template<typename Fn>
+		void forEach(Fn&& fn) const
+		{
+			for (size_t y = 0; y < m_sizeY; ++y) {
+				const Word* words = row(y);
+				for (size_t w = 0; w < m_rowWords; ++w) {
+					for (Word word = words[w]; word != 0; word &= word - 1) {
+						fn(w * WORD_BITS + std::countr_zero(word), y);
+					}
+				}
+			}
+		}
+
+		Word* row(size_t y) { return &m_words[y * m_rowWords]; }
+		const Word* row(size_t y) const { return &m_words[y * m_rowWords]; }
+
+		BitGrid& operator|=(const BitGrid& other)
+		{
+			checkSize(other);
+			for (size_t i = 0; i < m_words.size(); ++i) {
+				m_words[i] |= other.m_words[i];
+			}
+			return *this;
+		}
+
+		BitGrid& operator&=(const BitGrid& other)
+		{
+			checkSize(other);
+			for (size_t i = 0; i < m_words.size(); ++i) {
+				m_words[i] &= other.m_words[i];
+			}
+			return *this;
+		}
+
+		// Removes the cells set in other
+		BitGrid& andNot(const BitGrid& other)
+		{
+			checkSize(other);
+			for (size_t i = 0; i < m_words.size(); ++i) {
+				m_words[i] &= ~other.m_words[i];
+			}
+			return *this;
+		}
+
+		bool operator==(const BitGrid& other) const = default;
+
+		// Every cell moved one column right, the last column falls off
+		BitGrid shiftedRight() const
+		{
+			BitGrid result(m_sizeX, m_sizeY);
+			for (size_t y = 0; y < m_sizeY; ++y) {
+				const Word* from = row(y);
+				Word* to = result.row(y);
+				Word carry = 0;
+				for (size_t w = 0; w < m_rowWords; ++w) {
+					to[w] = (from[w] << 1) | carry;
+					carry = from[w] >> (WORD_BITS - 1);
+				}
+				result.maskRow(y);
+			}
+			return result;
+		}
+
+		// Every cell moved one column left, the first column falls off
+		BitGrid shiftedLeft() const
+		{
+			BitGrid result(m_sizeX, m_sizeY);
+			for (size_t y = 0; y < m_sizeY; ++y) {
+				const Word* from = row(y);
+				Word* to = result.row(y);
+				for (size_t w = 0; w < m_rowWords; ++w) {
+					Word carry = w + 1 < m_rowWords ? from[w + 1] << (WORD_BITS - 1) : 0;
+					to[w] = (from[w] >> 1) | carry;
+				}
+			}
+			return result;
+		}
+
+		// Every cell moved one row down, the last row falls off
+		BitGrid shiftedDown() const
+		{
+			BitGrid result(m_sizeX, m_sizeY);
+			if (m_sizeY > 1) {
+				std::copy(m_words.begin(), m_words.end() - m_rowWords, result.m_words.begin() + m_rowWords);
+			}
+			return result;
+		}
+
+		// Every cell moved one row up, the first row falls off
+		BitGrid shiftedUp() const
+		{
+			BitGrid result(m_sizeX, m_sizeY);
+			if (m_sizeY > 1) {
+				std::copy(m_words.begin() + m_rowWords, m_words.end(), result.m_words.begin());
+			}
+			return result;
+		}
+
+		// Grows the set cells through the 4-neighbourhood inside passable until
+		// nothing changes. Each round moves the whole front at once, a word at a
+		// time, so it suits open areas more than long winding paths.
+		BitGrid& floodFill(const BitGrid& passable)
+		{
+			checkSize(passable);
+			*this &= passable;
+			std::vector<Word> grown(m_words.size());
+			bool changed = true;
+			while (changed) {
+				changed = false;
+				for (size_t y = 0; y < m_sizeY; ++y) {
+					const Word* current = row(y);
+					const Word* above = y > 0 ? row(y - 1) : nullptr;
+					const Word* below = y + 1 < m_sizeY ? row(y + 1) : nullptr;
+					const Word* open = passable.row(y);
+					Word* to = &grown[y * m_rowWords];
+					for (size_t w = 0; w < m_rowWords; ++w) {
+						Word fromLeft = (current[w] << 1) | (w > 0 ? current[w - 1] >> (WORD_BITS - 1) : 0);
+						Word fromRight = (current[w] >> 1) | (w + 1 < m_rowWords ? current[w + 1] << (WORD_BITS - 1) : 0);
+						Word vertical = (above ? above[w] : 0) | (below ? below[w] : 0);
+						to[w] = (current[w] | fromLeft | fromRight | vertical) & open[w];
+						changed |= to[w] != current[w];
+					}
+				}
+				m_words.swap(grown);
+			}
+			return *this;
+		}
+
+	private:
+		size_t wordIndex(size_t x, size_t y) const
+		{
+			return y * m_rowWords + x / WORD_BITS;
+		}
+
+		static Word bit(size_t x)
+		{
+			return Word{ 1 } << (x % WORD_BITS);
+		}
+
+		void maskRow(size_t y)
+		{
+			size_t usedBits = m_sizeX % WORD_BITS;
+			if (usedBits != 0) {
+				row(y)[m_rowWords - 1] &= (Word{ 1 } << usedBits) - 1;
+			}
+		}
+
+		void checkSize(const BitGrid& other) const
+		{
+			if (other.m_sizeX != m_sizeX || other.m_sizeY != m_sizeY) {
+				throw std::invalid_argument("BitGrids of different sizes");
+			}
+		}
+
+		size_t m_sizeX{};
+		size_t m_sizeY{};
+		size_t m_rowWords{};
+		std::vector<Word> m_words;
+	};
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <optional>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include "FlatHash.hpp"
+
+namespace aoc {
+	using Vertex = uint32_t;
+
+	template<typename Weight>
+	struct CsrEdge
+	{
+		Vertex from;
+		Vertex to;
+		Weight weight;
+	};
+
+	template<>
+	struct CsrEdge<void>
+	{
+		Vertex from;
+		Vertex to;
+	};
+
+
+	// Directed graph in compressed sparse row form. Vertices are the ids
+	// 0..vertexCount-1, the edges leaving vertex v are the range
+	// [offsets[v], offsets[v+1]) of one targets array and one weights array,
+	// so walking a vertex's edges reads contiguous memory. It's built once
+	// from an edge list in two passes, counting the degrees and then placing
+	// every edge, and stays immutable. Targets of a vertex are sorted, which
+	// makes hasEdge a binary search. Weight void leaves out the weights.
+	template<typename Weight = void>
+	class CsrGraph
+	{
+	public:
+		using Edge = CsrEdge<Weight>;
+		static constexpr bool WEIGHTED = !std::is_void_v<Weight>;
+		// Placeholder element of the unused weights array of an unweighted graph
+		using StoredWeight = std::conditional_t<WEIGHTED, Weight, char>;
+
+		CsrGraph() = default;
+
+		CsrGraph(size_t vertexCount, std::span<const Edge> edges)
+			: m_offsets(vertexCount + 1), m_targets(edges.size())
+		{
+			for (const Edge& edge : edges) {
+				if (edge.from >= vertexCount || edge.to >= vertexCount) {
+					throw std::out_of_range("Edge vertex out of the graph");
+				}
+				++m_offsets[edge.from + 1];
+			}
+			std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+			if constexpr (WEIGHTED) {
+				m_weights.resize(edges.size());
+			}
+			std::vector<size_t> next(m_offsets.begin(), m_offsets.end() - 1);
+			for (const Edge& edge : edges) {
+				size_t idx = next[edge.from]++;
+				m_targets[idx] = edge.to;
+				if constexpr (WEIGHTED) {
+					m_weights[idx] = edge.weight;
+				}
+			}
+			sortTargets();
+		}
+
+		size_t vertexCount() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+		size_t edgeCount() const { return m_targets.size(); }
+		size_t degree(Vertex v) const { return m_offsets[v + 1] - m_offsets[v]; }
+
+		std::span<const Vertex> targets(Vertex v) const
+		{
+			return { m_targets.data() + m_offsets[v], degree(v) };
+		}
+
+		// Weights of the edges of v, in the order of targets(v)
+		std::span<const StoredWeight> weights(Vertex v) const requires WEIGHTED
+		{
+			return { m_weights.data() + m_offsets[v], degree(v) };
+		}
+
+		bool hasEdge(Vertex from, Vertex to) const
+		{
+			auto edges = targets(from);
+			return std::binary_search(edges.begin(), edges.end(), to);
+		}
+
+		// Same vertices with every edge reversed
+		CsrGraph transposed() const
+		{
+			std::vector<Edge> edges;
+			edges.reserve(edgeCount());
+			for (Vertex v = 0; v < vertexCount(); ++v) {
+				for (size_t i = m_offsets[v]; i < m_offsets[v + 1]; ++i) {
+					if constexpr (WEIGHTED) {
+						edges.push_back({ m_targets[i], v, m_weights[i] });
+					}
+					else {
+						edges.push_back({ m_targets[i], v });
+					}
+				}
+			}
+			return CsrGraph(vertexCount(), edges);
+		}
+
+	private:
+		void sortTargets()
+		{
+			std::vector<std::pair<Vertex, StoredWeight>> row;
+			for (Vertex v = 0; v < vertexCount(); ++v) {
+				auto begin = m_targets.begin() + m_offsets[v];
+				auto end = m_targets.begin() + m_offsets[v + 1];
+				if constexpr (!WEIGHTED) {
+					std::sort(begin, end);
+				}
+				else if (!std::is_sorted(begin, end)) {
+					row.clear();
+					for (size_t i = m_offsets[v]; i < m_offsets[v + 1]; ++i) {
+						row.emplace_back(m_targets[i], m_weights[i]);
+					}
+					std::sort(row.begin(), row.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+					for (size_t i = 0; i < row.size(); ++i) {
+						m_targets[m_offsets[v] + i] = row[i].first;
+						m_weights[m_offsets[v] + i] = row[i].second;
+					}
+				}
+			}
+		}
+
+		std::vector<size_t> m_offsets;
+		std::vector<Vertex> m_targets;
+		std::vector<StoredWeight> m_weights;
+	};
+
+
+	// Gives labels dense vertex ids in the order they're first seen
+	template<typename Label, typename Hash = aoc::Hash<Label>>
+	class LabelInterner
+	{
+	public:
+		Vertex intern(const Label& label)
+		{
+			auto [it, inserted] = m_ids.try_emplace(label, static_cast<Vertex>(m_labels.size()));
+			if (inserted) {
+				m_labels.push_back(label);
+			}
+			return it->second;
+		}
+
+		std::optional<Vertex> find(const Label& label) const
+		{
+			auto it = m_ids.find(label);
+			if (it == m_ids.end()) {
+				return std::nullopt;
+			}
+			return it->second;
+		}
+
+		Vertex at(const Label& label) const
+		{
+			if (auto id = find(label)) {
+				return *id;
+			}
+			throw std::out_of_range("Unknown vertex label");
+		}
+
+		const Label& label(Vertex v) const { return m_labels[v]; }
+		const std::vector<Label>& labels() const { return m_labels; }
+		size_t size() const { return m_labels.size(); }
+
+		void reserve(size_t count)
+		{
+			m_ids.reserve(count);
+			m_labels.reserve(count);
+		}
+
+	private:
+		aoc::FlatMap<Label, Vertex, Hash> m_ids;
+		std::vector<Label> m_labels;
+	};
+}
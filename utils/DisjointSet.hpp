@@ -0,0 +1,100 @@
+#pragma once
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "Grid.hpp"
+
+namespace aoc {
+	// Union-find over the dense indices 0..size-1. Union by rank keeps the
+	// trees shallow and find halves the path it walks, so a sequence of
+	// operations costs next to linear time. Every root knows the size of its
+	// component. Sets can only grow together, removal isn't supported.
+	class DisjointSet
+	{
+	public:
+		using Index = size_t;
+
+		DisjointSet() = default;
+
+		explicit DisjointSet(size_t size)
+			: m_parents(size), m_ranks(size, 0), m_sizes(size, 1), m_components{ size }
+		{
+			std::iota(m_parents.begin(), m_parents.end(), Index{});
+		}
+
+		size_t size() const { return m_parents.size(); }
+		size_t componentCount() const { return m_components; }
+
+		Index find(Index idx)
+		{
+			while (m_parents[idx] != idx) {
+				m_parents[idx] = m_parents[m_parents[idx]];
+				idx = m_parents[idx];
+			}
+			return idx;
+		}
+
+		// Joins the components of a and b, false when they were one already
+		bool unite(Index a, Index b)
+		{
+			a = find(a);
+			b = find(b);
+			if (a == b) {
+				return false;
+			}
+
+			if (m_ranks[a] < m_ranks[b]) {
+				std::swap(a, b);
+			}
+			m_parents[b] = a;
+			m_sizes[a] += m_sizes[b];
+			if (m_ranks[a] == m_ranks[b]) {
+				++m_ranks[a];
+			}
+			--m_components;
+			return true;
+		}
+
+		bool connected(Index a, Index b)
+		{
+			return find(a) == find(b);
+		}
+
+		size_t componentSize(Index idx)
+		{
+			return m_sizes[find(idx)];
+		}
+
+	private:
+		std::vector<Index> m_parents;
+		std::vector<uint8_t> m_ranks;
+		// Valid for roots only
+		std::vector<size_t> m_sizes;
+		size_t m_components{};
+	};
+
+
+	// Components of the inner cells of a grid, indexed like its cells. Cells
+	// are joined with their right and lower neighbours when joined(from, to)
+	// allows, in one pass over the grid. Border cells stay on their own.
+	template<typename T, typename Joined>
+	DisjointSet labelGrid(const Grid<T>& grid, Joined&& joined)
+	{
+		using Index = typename Grid<T>::Index;
+		DisjointSet components(grid.cellCount());
+		for (size_t y = 0; y < grid.sizeY(); ++y) {
+			Index idx = grid.index(0, y);
+			for (size_t x = 0; x < grid.sizeX(); ++x, ++idx) {
+				if (x + 1 < grid.sizeX() && joined(idx, idx + 1)) {
+					components.unite(idx, idx + 1);
+				}
+				if (y + 1 < grid.sizeY() && joined(idx, idx + grid.stride())) {
+					components.unite(idx, idx + grid.stride());
+				}
+			}
+		}
+		return components;
+	}
+}
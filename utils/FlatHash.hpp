@@ -0,0 +1,601 @@
+#pragma once
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <utility>
+#include <tuple>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include "utils.hpp"
+
+namespace aoc {
+	// Default hash of the flat containers. std::hash of an integer is the
+	// identity in both libstdc++ and MSVC, which makes linear probing build long
+	// runs, so the result is mixed unless the key specializes aoc::Hash itself.
+	template<typename T>
+	struct Hash
+	{
+		size_t operator()(const T& value) const
+		{
+			return static_cast<size_t>(mixHash(std::hash<T>{}(value)));
+		}
+	};
+
+	template<>
+	struct Hash<Position>
+	{
+		size_t operator()(const Position& p) const
+		{
+			return std::hash<Position>{}(p);
+		}
+	};
+
+	namespace detail {
+		struct SetKeyOf
+		{
+			template<typename Key>
+			const Key& operator()(const Key& key) const { return key; }
+		};
+
+		struct MapKeyOf
+		{
+			template<typename Pair>
+			const auto& operator()(const Pair& pair) const { return pair.first; }
+		};
+
+		// Open addressing with linear probing, all slots in one array. Capacity is
+		// a power of two kept at most half full, erase shifts the rest of the probe
+		// run back instead of leaving tombstones, so lookups never slow down.
+		template<typename Key, typename Slot, typename KeyOf, typename Hash, typename KeyEqual, typename Allocator>
+		class FlatTable
+		{
+			using SlotAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+			using SlotTraits = std::allocator_traits<SlotAlloc>;
+			using UsedAlloc = typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t>;
+			using UsedTraits = std::allocator_traits<UsedAlloc>;
+
+			static constexpr size_t MIN_CAPACITY = 8;
+
+			template<bool IsConst>
+			class Iterator
+			{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Slot;
+				using difference_type = std::ptrdiff_t;
+				using pointer = std::conditional_t<IsConst, const Slot*, Slot*>;
+				using reference = std::conditional_t<IsConst, const Slot&, Slot&>;
+
+				Iterator() = default;
+
+				Iterator(pointer slots, const uint8_t* used, size_t idx, size_t capacity)
+					: m_slots{ slots }, m_used{ used }, m_idx{ idx }, m_capacity{ capacity }
+				{}
+
+				operator Iterator<true>() const requires (!IsConst)
+				{
+					return { m_slots, m_used, m_idx, m_capacity };
+				}
+
+				reference operator*() const { return m_slots[m_idx]; }
+				pointer operator->() const { return m_slots + m_idx; }
+
+				Iterator& operator++()
+				{
+					++m_idx;
+					skipEmpty();
+					return *this;
+				}
+
+				Iterator operator++(int)
+				{
+					Iterator copy{ *this };
+					++(*this);
+					return copy;
+				}
+
+				bool operator==(const Iterator& it) const { return m_idx == it.m_idx; }
+
+				void skipEmpty()
+				{
+					while (m_idx < m_capacity && !m_used[m_idx]) {
+						++m_idx;
+					}
+				}
+
+			private:
+				pointer m_slots = nullptr;
+				const uint8_t* m_used = nullptr;
+				size_t m_idx = 0;
+				size_t m_capacity = 0;
+			};
+
+		public:
+			using key_type = Key;
+			using value_type = Slot;
+			using size_type = size_t;
+			using hasher = Hash;
+			using key_equal = KeyEqual;
+			using allocator_type = Allocator;
+			// Keys of a set must not be modified in place
+			using iterator = Iterator<std::is_same_v<Key, Slot>>;
+			using const_iterator = Iterator<true>;
+
+			FlatTable() = default;
+
+			explicit FlatTable(const Allocator& alloc)
+				: m_alloc{ alloc }
+			{}
+
+			FlatTable(const FlatTable& other)
+				: m_hash{ other.m_hash }, m_equal{ other.m_equal },
+				m_alloc{ SlotTraits::select_on_container_copy_construction(other.m_alloc) }
+			{
+				copyFrom(other);
+			}
+
+			FlatTable(FlatTable&& other) noexcept
+				: m_hash{ std::move(other.m_hash) }, m_equal{ std::move(other.m_equal) },
+				m_alloc{ std::move(other.m_alloc) }
+			{
+				steal(other);
+			}
+
+			// Allocator-extended copy and move, these make the tables usable as
+			// elements of pmr containers, which construct them with their own allocator
+			FlatTable(const FlatTable& other, const Allocator& alloc)
+				: m_hash{ other.m_hash }, m_equal{ other.m_equal }, m_alloc{ alloc }
+			{
+				copyFrom(other);
+			}
+
+			FlatTable(FlatTable&& other, const Allocator& alloc)
+				: m_hash{ std::move(other.m_hash) }, m_equal{ std::move(other.m_equal) }, m_alloc{ alloc }
+			{
+				if (m_alloc == other.m_alloc) {
+					steal(other);
+				}
+				else {
+					moveElementsFrom(other);
+				}
+			}
+
+			FlatTable& operator=(const FlatTable& other)
+			{
+				if (this != &other) {
+					clear();
+					if constexpr (SlotTraits::propagate_on_container_copy_assignment::value) {
+						if (m_alloc != other.m_alloc) {
+							release();
+						}
+						m_alloc = other.m_alloc;
+					}
+					m_hash = other.m_hash;
+					m_equal = other.m_equal;
+					copyFrom(other);
+				}
+				return *this;
+			}
+
+			FlatTable& operator=(FlatTable&& other)
+			{
+				if (this == &other) {
+					return *this;
+				}
+
+				m_hash = std::move(other.m_hash);
+				m_equal = std::move(other.m_equal);
+				if constexpr (SlotTraits::propagate_on_container_move_assignment::value) {
+					release();
+					m_alloc = std::move(other.m_alloc);
+					steal(other);
+				}
+				else if (m_alloc == other.m_alloc) {
+					release();
+					steal(other);
+				}
+				else {
+					clear();
+					moveElementsFrom(other);
+				}
+				return *this;
+			}
+
+			~FlatTable()
+			{
+				release();
+			}
+
+			size_t size() const { return m_size; }
+			bool empty() const { return m_size == 0; }
+			size_t capacity() const { return m_capacity; }
+			allocator_type get_allocator() const { return allocator_type(m_alloc); }
+
+			iterator begin() { return iteratorAt(0, true); }
+			iterator end() { return iteratorAt(m_capacity); }
+			const_iterator begin() const { return constIteratorAt(0, true); }
+			const_iterator end() const { return constIteratorAt(m_capacity); }
+
+			// Makes room for count elements, so inserting up to that many never rehashes
+			void reserve(size_t count)
+			{
+				size_t needed = capacityFor(count);
+				if (needed > m_capacity) {
+					rehash(needed);
+				}
+			}
+
+			// Destroys elements but keeps the table, so refilling it doesn't allocate
+			void clear()
+			{
+				if (m_size == 0) {
+					return;
+				}
+
+				for (size_t i = 0; i < m_capacity; ++i) {
+					if (m_used[i]) {
+						SlotTraits::destroy(m_alloc, m_slots + i);
+					}
+				}
+				std::fill_n(m_used, m_capacity, uint8_t{ 0 });
+				m_size = 0;
+			}
+
+			iterator find(const Key& key)
+			{
+				auto [idx, found] = probe(key);
+				return found ? iteratorAt(idx) : end();
+			}
+
+			const_iterator find(const Key& key) const
+			{
+				auto [idx, found] = probe(key);
+				return found ? constIteratorAt(idx) : end();
+			}
+
+			bool contains(const Key& key) const
+			{
+				return probe(key).second;
+			}
+
+			size_t count(const Key& key) const
+			{
+				return contains(key) ? 1 : 0;
+			}
+
+			size_t erase(const Key& key)
+			{
+				auto [idx, found] = probe(key);
+				if (!found) {
+					return 0;
+				}
+
+				eraseAt(idx);
+				return 1;
+			}
+
+		protected:
+			// Looks key up and constructs the slot from args only if it is missing
+			template<typename... Args>
+			std::pair<iterator, bool> emplaceKey(const Key& key, Args&&... args)
+			{
+				auto [idx, found] = probe(key);
+				if (found) {
+					return { iteratorAt(idx), false };
+				}
+
+				if (capacityFor(m_size + 1) > m_capacity) {
+					rehash(std::max(MIN_CAPACITY, m_capacity * 2));
+					idx = probe(key).first;
+				}
+
+				SlotTraits::construct(m_alloc, m_slots + idx, std::forward<Args>(args)...);
+				m_used[idx] = 1;
+				++m_size;
+				return { iteratorAt(idx), true };
+			}
+
+		private:
+			// First slot holding key, or the empty slot ending its probe run
+			std::pair<size_t, bool> probe(const Key& key) const
+			{
+				if (m_capacity == 0) {
+					return { 0, false };
+				}
+
+				size_t mask = m_capacity - 1;
+				size_t idx = m_hash(key) & mask;
+				while (m_used[idx]) {
+					if (m_equal(KeyOf{}(m_slots[idx]), key)) {
+						return { idx, true };
+					}
+					idx = (idx + 1) & mask;
+				}
+				return { idx, false };
+			}
+
+			// Only for slots known not to be in the table yet
+			void insertUnique(Slot&& slot)
+			{
+				size_t mask = m_capacity - 1;
+				size_t idx = m_hash(KeyOf{}(slot)) & mask;
+				while (m_used[idx]) {
+					idx = (idx + 1) & mask;
+				}
+
+				SlotTraits::construct(m_alloc, m_slots + idx, std::move(slot));
+				m_used[idx] = 1;
+				++m_size;
+			}
+
+			void eraseAt(size_t hole)
+			{
+				size_t mask = m_capacity - 1;
+				SlotTraits::destroy(m_alloc, m_slots + hole);
+				m_used[hole] = 0;
+				--m_size;
+
+				// Pull back every element of the run that would no longer be reachable
+				// from its home slot, i.e. whose home isn't between the hole and itself
+				for (size_t idx = (hole + 1) & mask; m_used[idx]; idx = (idx + 1) & mask) {
+					size_t home = m_hash(KeyOf{}(m_slots[idx])) & mask;
+					if (((idx - home) & mask) < ((idx - hole) & mask)) {
+						continue;
+					}
+
+					SlotTraits::construct(m_alloc, m_slots + hole, std::move(m_slots[idx]));
+					SlotTraits::destroy(m_alloc, m_slots + idx);
+					m_used[hole] = 1;
+					m_used[idx] = 0;
+					hole = idx;
+				}
+			}
+
+			void rehash(size_t newCapacity)
+			{
+				Slot* oldSlots = m_slots;
+				uint8_t* oldUsed = m_used;
+				size_t oldCapacity = m_capacity;
+
+				m_slots = SlotTraits::allocate(m_alloc, newCapacity);
+				UsedAlloc usedAlloc(m_alloc);
+				m_used = UsedTraits::allocate(usedAlloc, newCapacity);
+				std::fill_n(m_used, newCapacity, uint8_t{ 0 });
+				m_capacity = newCapacity;
+				m_size = 0;
+
+				for (size_t i = 0; i < oldCapacity; ++i) {
+					if (oldUsed[i]) {
+						insertUnique(std::move(oldSlots[i]));
+						SlotTraits::destroy(m_alloc, oldSlots + i);
+					}
+				}
+
+				if (oldCapacity != 0) {
+					SlotTraits::deallocate(m_alloc, oldSlots, oldCapacity);
+					UsedTraits::deallocate(usedAlloc, oldUsed, oldCapacity);
+				}
+			}
+
+			void release()
+			{
+				clear();
+				if (m_capacity != 0) {
+					UsedAlloc usedAlloc(m_alloc);
+					SlotTraits::deallocate(m_alloc, m_slots, m_capacity);
+					UsedTraits::deallocate(usedAlloc, m_used, m_capacity);
+				}
+				m_slots = nullptr;
+				m_used = nullptr;
+				m_capacity = 0;
+			}
+
+			void steal(FlatTable& other)
+			{
+				m_slots = std::exchange(other.m_slots, nullptr);
+				m_used = std::exchange(other.m_used, nullptr);
+				m_capacity = std::exchange(other.m_capacity, 0);
+				m_size = std::exchange(other.m_size, 0);
+			}
+
+			// Memory of other belongs to another resource, elements have to move one by one
+			void moveElementsFrom(FlatTable& other)
+			{
+				reserve(other.size());
+				for (size_t i = 0; i < other.m_capacity; ++i) {
+					if (other.m_used[i]) {
+						insertUnique(std::move(other.m_slots[i]));
+					}
+				}
+				other.clear();
+			}
+
+			void copyFrom(const FlatTable& other)
+			{
+				reserve(other.size());
+				for (size_t i = 0; i < other.m_capacity; ++i) {
+					if (other.m_used[i]) {
+						Slot copy{ other.m_slots[i] };
+						insertUnique(std::move(copy));
+					}
+				}
+			}
+
+			static size_t capacityFor(size_t count)
+			{
+				return std::max(MIN_CAPACITY, std::bit_ceil(count * 2));
+			}
+
+			iterator iteratorAt(size_t idx, bool skipEmpty = false)
+			{
+				iterator it{ m_slots, m_used, idx, m_capacity };
+				if (skipEmpty) {
+					it.skipEmpty();
+				}
+				return it;
+			}
+
+			const_iterator constIteratorAt(size_t idx, bool skipEmpty = false) const
+			{
+				const_iterator it{ m_slots, m_used, idx, m_capacity };
+				if (skipEmpty) {
+					it.skipEmpty();
+				}
+				return it;
+			}
+
+			Slot* m_slots = nullptr;
+			uint8_t* m_used = nullptr;
+			size_t m_capacity = 0;
+			size_t m_size = 0;
+			[[no_unique_address]] Hash m_hash{};
+			[[no_unique_address]] KeyEqual m_equal{};
+			[[no_unique_address]] SlotAlloc m_alloc{};
+		};
+	}
+
+
+	// Drop-in for std::unordered_set in hot loops, without a node per element.
+	// Iteration order is unspecified and any insert may invalidate iterators.
+	template<typename Key, typename Hash = aoc::Hash<Key>, typename KeyEqual = std::equal_to<Key>, typename Allocator = std::allocator<Key>>
+	class FlatSet : public detail::FlatTable<Key, Key, detail::SetKeyOf, Hash, KeyEqual, Allocator>
+	{
+		using Base = detail::FlatTable<Key, Key, detail::SetKeyOf, Hash, KeyEqual, Allocator>;
+
+	public:
+		using typename Base::iterator;
+		using Base::Base;
+
+		FlatSet() = default;
+
+		FlatSet(std::initializer_list<Key> keys)
+		{
+			insert(keys.begin(), keys.end());
+		}
+
+		template<typename It>
+		FlatSet(It first, It last)
+		{
+			insert(first, last);
+		}
+
+		std::pair<iterator, bool> insert(const Key& key)
+		{
+			return this->emplaceKey(key, key);
+		}
+
+		std::pair<iterator, bool> insert(Key&& key)
+		{
+			return this->emplaceKey(key, std::move(key));
+		}
+
+		template<typename It>
+		void insert(It first, It last)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			return insert(Key(std::forward<Args>(args)...));
+		}
+	};
+
+
+	// Drop-in for std::unordered_map in hot loops, without a node per element.
+	// Iteration order is unspecified and any insert may invalidate references.
+	template<typename Key, typename Value, typename Hash = aoc::Hash<Key>, typename KeyEqual = std::equal_to<Key>,
+		typename Allocator = std::allocator<std::pair<const Key, Value>>>
+	class FlatMap : public detail::FlatTable<Key, std::pair<const Key, Value>, detail::MapKeyOf, Hash, KeyEqual, Allocator>
+	{
+		using Base = detail::FlatTable<Key, std::pair<const Key, Value>, detail::MapKeyOf, Hash, KeyEqual, Allocator>;
+
+	public:
+		using mapped_type = Value;
+		using typename Base::value_type;
+		using typename Base::iterator;
+		using Base::Base;
+
+		FlatMap() = default;
+
+		FlatMap(std::initializer_list<value_type> values)
+		{
+			for (const auto& value : values) {
+				insert(value);
+			}
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			return this->emplaceKey(key, std::piecewise_construct,
+				std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		template<typename V>
+		std::pair<iterator, bool> emplace(const Key& key, V&& value)
+		{
+			return try_emplace(key, std::forward<V>(value));
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value)
+		{
+			return try_emplace(value.first, value.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& value)
+		{
+			return try_emplace(value.first, std::move(value.second));
+		}
+
+		template<typename It>
+		void insert(It first, It last)
+		{
+			for (; first != last; ++first) {
+				insert(*first);
+			}
+		}
+
+		Value& operator[](const Key& key)
+		{
+			return try_emplace(key).first->second;
+		}
+
+		Value& at(const Key& key)
+		{
+			auto it = this->find(key);
+			if (it == this->end()) {
+				throw std::out_of_range("FlatMap doesn't contain the key");
+			}
+			return it->second;
+		}
+
+		const Value& at(const Key& key) const
+		{
+			auto it = this->find(key);
+			if (it == this->end()) {
+				throw std::out_of_range("FlatMap doesn't contain the key");
+			}
+			return it->second;
+		}
+	};
+}
+
+
+namespace aoc::pmr {
+	// Flat containers allocating from a std::pmr::memory_resource, e.g. an aoc::Arena
+	template<typename Key, typename Hash = aoc::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	using FlatSet = aoc::FlatSet<Key, Hash, KeyEqual, std::pmr::polymorphic_allocator<Key>>;
+
+	template<typename Key, typename Value, typename Hash = aoc::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	using FlatMap = aoc::FlatMap<Key, Value, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
+}
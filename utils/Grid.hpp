@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+#include "utils.hpp"
+
+namespace aoc {
+	// Rectangular board stored row by row in one buffer. It can be surrounded
+	// by a border of sentinel cells, so walking to a neighbour of any inner
+	// cell never leaves the buffer and needs no bounds check.
+	template<typename T>
+	class Grid
+	{
+		static_assert(!std::is_same_v<T, bool>, "vector<bool> isn't contiguous, use uint8_t");
+
+	public:
+		using Index = size_t;
+		using Offset = std::ptrdiff_t;
+
+		Grid() = default;
+
+		Grid(size_t sizeX, size_t sizeY, const T& value = {}, size_t border = 0, const T& sentinel = {})
+			: m_sizeX{ sizeX }, m_sizeY{ sizeY }, m_border{ border },
+			m_stride{ sizeX + 2 * border },
+			m_cells((sizeY + 2 * border) * m_stride, sentinel)
+		{
+			for (size_t y = 0; y < m_sizeY; ++y) {
+				std::fill_n(m_cells.begin() + index(0, y), m_sizeX, value);
+			}
+		}
+
+		// Converts every char of every line with transform, lines must be equally long
+		template<typename Lines, typename Transform>
+		static Grid fromLines(const Lines& lines, Transform transform, size_t border = 0, const T& sentinel = {})
+		{
+			size_t sizeY = 0;
+			size_t sizeX = 0;
+			for (std::string_view line : lines) {
+				if (sizeY == 0) {
+					sizeX = line.size();
+				}
+				else if (line.size() != sizeX) {
+					throw std::invalid_argument("Board is not rectangular!");
+				}
+				++sizeY;
+			}
+
+			Grid grid(sizeX, sizeY, sentinel, border, sentinel);
+			int64_t y = 0;
+			for (std::string_view line : lines) {
+				T* row = &grid[grid.index(0, y++)];
+				for (size_t x = 0; x < sizeX; ++x) {
+					row[x] = transform(line[x]);
+				}
+			}
+
+			return grid;
+		}
+
+		size_t sizeX() const { return m_sizeX; }
+		size_t sizeY() const { return m_sizeY; }
+		size_t border() const { return m_border; }
+		size_t stride() const { return m_stride; }
+
+		// Number of cells in the buffer, border included
+		size_t cellCount() const { return m_cells.size(); }
+
+		bool contains(const Position& p) const
+		{
+			return p.x >= 0 && p.x < (int64_t)m_sizeX && p.y >= 0 && p.y < (int64_t)m_sizeY;
+		}
+
+		Index index(int64_t x, int64_t y) const
+		{
+			return (y + m_border) * m_stride + (x + m_border);
+		}
+
+		Index index(const Position& p) const
+		{
+			return index(p.x, p.y);
+		}
+
+		Position position(Index idx) const
+		{
+			return { (int64_t)(idx % m_stride) - (int64_t)m_border, (int64_t)(idx / m_stride) - (int64_t)m_border };
+		}
+
+		Offset offset(const Vec2D& v) const
+		{
+			return v.y * (Offset)m_stride + v.x;
+		}
+
+		// In order of Vec2D::getUnitVectors()
+		std::array<Offset, 4> neighbourOffsets() const
+		{
+			std::array<Offset, 4> offsets;
+			auto unitVectors = Vec2D::getUnitVectors();
+			for (size_t i = 0; i < offsets.size(); ++i) {
+				offsets[i] = offset(unitVectors[i]);
+			}
+			return offsets;
+		}
+
+		// Clockwise, starting from right
+		std::array<Offset, 8> allNeighbourOffsets() const
+		{
+			Offset s = (Offset)m_stride;
+			return { 1, s + 1, s, s - 1, -1, -s - 1, -s, -s + 1 };
+		}
+
+		T& at(const Position& p) { return m_cells[index(p)]; }
+		const T& at(const Position& p) const { return m_cells[index(p)]; }
+
+		T& operator[](Index idx) { return m_cells[idx]; }
+		const T& operator[](Index idx) const { return m_cells[idx]; }
+
+		T* data() { return m_cells.data(); }
+		const T* data() const { return m_cells.data(); }
+
+	private:
+		size_t m_sizeX{};
+		size_t m_sizeY{};
+		size_t m_border{};
+		size_t m_stride{};
+		std::vector<T> m_cells;
+	};
+}
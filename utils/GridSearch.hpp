@@ -0,0 +1,195 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "Grid.hpp"
+
+namespace aoc {
+	// Breadth first and Dijkstra searches over the linear indices of a Grid.
+	// Distances live in a dense array indexed like the grid's cells and the
+	// frontier is a plain array of indices, so a search touches no hash table
+	// and allocates nothing once the arrays have grown to the grid. Cells are
+	// marked with the number of the search that reached them, which makes
+	// starting another search on the same object O(1) instead of a clear.
+	//
+	// Neighbours are taken by index offsets without bounds checks, the grid
+	// needs a border of cells canStep refuses to enter. canStep(from, to) and
+	// onVisit are template parameters, so they inline into the search loop.
+	class GridSearch
+	{
+	public:
+		using Index = size_t;
+		using Offset = std::ptrdiff_t;
+		using Distance = uint32_t;
+
+		static constexpr Distance UNREACHED = UINT32_MAX;
+
+		GridSearch() = default;
+
+		// Visits every cell reachable from sources by steps canStep(from, to)
+		// allows, nearest first. onVisit(idx, distance) is called when a cell is
+		// taken from the frontier, returning false ends the search there.
+		template<typename CanStep, typename OnVisit>
+		void bfs(size_t cellCount, std::span<const Index> sources, std::span<const Offset> offsets,
+			CanStep&& canStep, OnVisit&& onVisit)
+		{
+			start(cellCount);
+			for (Index source : sources) {
+				discover(source, 0);
+			}
+
+			for (size_t head = 0; head < m_frontier.size(); ++head) {
+				Index current = m_frontier[head];
+				Distance distance = m_distances[current];
+				if (!onVisit(current, distance)) {
+					return;
+				}
+
+				for (Offset offset : offsets) {
+					Index next = current + offset;
+					if (!reached(next) && canStep(current, next)) {
+						discover(next, distance + 1);
+					}
+				}
+			}
+		}
+
+		// Like bfs with stepCost(from, to) instead of canStep, UNREACHED marks a
+		// step that can't be taken. Costs of a path must sum below UNREACHED.
+		template<typename StepCost, typename OnVisit>
+		void dijkstra(size_t cellCount, std::span<const Index> sources, std::span<const Offset> offsets,
+			StepCost&& stepCost, OnVisit&& onVisit)
+		{
+			start(cellCount);
+			m_heap.clear();
+			auto closer = [](const HeapEntry& a, const HeapEntry& b) { return a.distance > b.distance; };
+			for (Index source : sources) {
+				m_marks[source] = m_search;
+				m_distances[source] = 0;
+				m_heap.push_back({ 0, source });
+			}
+			std::make_heap(m_heap.begin(), m_heap.end(), closer);
+
+			while (!m_heap.empty()) {
+				std::pop_heap(m_heap.begin(), m_heap.end(), closer);
+				HeapEntry entry = m_heap.back();
+				m_heap.pop_back();
+				// Stale entry of a cell reached cheaper later, or already settled
+				if (entry.distance != m_distances[entry.idx] || m_settled[entry.idx] == m_search) {
+					continue;
+				}
+
+				m_settled[entry.idx] = m_search;
+				m_frontier.push_back(entry.idx);
+				if (!onVisit(entry.idx, entry.distance)) {
+					return;
+				}
+
+				for (Offset offset : offsets) {
+					Index next = entry.idx + offset;
+					if (m_settled[next] == m_search) {
+						continue;
+					}
+
+					Distance cost = stepCost(entry.idx, next);
+					if (cost == UNREACHED) {
+						continue;
+					}
+
+					Distance distance = entry.distance + cost;
+					if (!reached(next) || distance < m_distances[next]) {
+						m_marks[next] = m_search;
+						m_distances[next] = distance;
+						m_heap.push_back({ distance, next });
+						std::push_heap(m_heap.begin(), m_heap.end(), closer);
+					}
+				}
+			}
+		}
+
+		// Results of the last search
+		bool reached(Index idx) const { return m_marks[idx] == m_search; }
+		Distance distance(Index idx) const { return reached(idx) ? m_distances[idx] : UNREACHED; }
+		// Cells in the order bfs found them or dijkstra settled them
+		std::span<const Index> visitOrder() const { return m_frontier; }
+
+	private:
+		struct HeapEntry
+		{
+			Distance distance;
+			Index idx;
+		};
+
+		void start(size_t cellCount)
+		{
+			if (m_marks.size() < cellCount) {
+				m_marks.resize(cellCount, 0);
+				m_settled.resize(cellCount, 0);
+				m_distances.resize(cellCount);
+				m_frontier.reserve(cellCount);
+			}
+
+			// Old marks could be taken for new ones after wrapping around
+			if (++m_search == 0) {
+				std::fill(m_marks.begin(), m_marks.end(), 0);
+				std::fill(m_settled.begin(), m_settled.end(), 0);
+				m_search = 1;
+			}
+			m_frontier.clear();
+		}
+
+		void discover(Index idx, Distance distance)
+		{
+			m_marks[idx] = m_search;
+			m_distances[idx] = distance;
+			m_frontier.push_back(idx);
+		}
+
+		uint32_t m_search = 0;
+		std::vector<uint32_t> m_marks;
+		std::vector<uint32_t> m_settled;
+		std::vector<Distance> m_distances;
+		// bfs queue, every cell enters once so it never needs to wrap
+		std::vector<Index> m_frontier;
+		std::vector<HeapEntry> m_heap;
+	};
+
+
+	// Searches over a grid from one cell with its 4 neighbours. The grid only
+	// gives the size and offsets, canStep and stepCost decide what is passable.
+	template<typename T, typename CanStep, typename OnVisit>
+	void gridBfs(GridSearch& search, const Grid<T>& grid, GridSearch::Index source,
+		CanStep&& canStep, OnVisit&& onVisit)
+	{
+		const auto offsets = grid.neighbourOffsets();
+		search.bfs(grid.cellCount(), std::span<const GridSearch::Index>(&source, 1), offsets,
+			std::forward<CanStep>(canStep), std::forward<OnVisit>(onVisit));
+	}
+
+	template<typename T, typename CanStep>
+	void gridBfs(GridSearch& search, const Grid<T>& grid, GridSearch::Index source, CanStep&& canStep)
+	{
+		gridBfs(search, grid, source, std::forward<CanStep>(canStep),
+			[](GridSearch::Index, GridSearch::Distance) { return true; });
+	}
+
+	template<typename T, typename StepCost, typename OnVisit>
+	void gridDijkstra(GridSearch& search, const Grid<T>& grid, GridSearch::Index source,
+		StepCost&& stepCost, OnVisit&& onVisit)
+	{
+		const auto offsets = grid.neighbourOffsets();
+		search.dijkstra(grid.cellCount(), std::span<const GridSearch::Index>(&source, 1), offsets,
+			std::forward<StepCost>(stepCost), std::forward<OnVisit>(onVisit));
+	}
+
+	template<typename T, typename StepCost>
+	void gridDijkstra(GridSearch& search, const Grid<T>& grid, GridSearch::Index source, StepCost&& stepCost)
+	{
+		gridDijkstra(search, grid, source, std::forward<StepCost>(stepCost),
+			[](GridSearch::Index, GridSearch::Distance) { return true; });
+	}
+}
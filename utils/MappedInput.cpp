@@ -0,0 +1,179 @@
+#include "MappedInput.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace aoc {
+	MappedInput::LineIterator::LineIterator(const char* begin, const char* end)
+		: m_begin{ begin }, m_next{ begin }, m_end{ end }
+	{
+		readLine();
+	}
+
+	MappedInput::LineIterator& MappedInput::LineIterator::operator++()
+	{
+		m_begin = m_next;
+		readLine();
+		return *this;
+	}
+
+	MappedInput::LineIterator MappedInput::LineIterator::operator++(int)
+	{
+		LineIterator copy{ *this };
+		++(*this);
+		return copy;
+	}
+
+	void MappedInput::LineIterator::readLine()
+	{
+		if (m_begin == m_end) {
+			m_line = {};
+			return;
+		}
+
+		const char* lineEnd = std::find(m_begin, m_end, '\n');
+		m_next = lineEnd == m_end ? m_end : lineEnd + 1;
+		if (lineEnd != m_begin && *(lineEnd - 1) == '\r') {
+			--lineEnd;
+		}
+		m_line = { m_begin, static_cast<size_t>(lineEnd - m_begin) };
+	}
+
+
+#ifdef _WIN32
+	MappedInput::MappedInput(const std::string& fileName)
+	{
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+			nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("Cannot open file: " + fileName);
+		}
+		m_file = file;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			unmap();
+			throw std::runtime_error("Cannot read size of file: " + fileName);
+		}
+
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		if (m_size == 0) {
+			return;
+		}
+
+		m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mapping == nullptr) {
+			unmap();
+			throw std::runtime_error("Cannot map file: " + fileName);
+		}
+
+		m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (m_data == nullptr) {
+			unmap();
+			throw std::runtime_error("Cannot map file: " + fileName);
+		}
+	}
+
+	void MappedInput::unmap()
+	{
+		if (m_data != nullptr) {
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping != nullptr) {
+			CloseHandle(m_mapping);
+		}
+		if (m_file != nullptr) {
+			CloseHandle(m_file);
+		}
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+	}
+#else
+	MappedInput::MappedInput(const std::string& fileName)
+	{
+		int fd = open(fileName.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error("Cannot open file: " + fileName);
+		}
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0) {
+			close(fd);
+			throw std::runtime_error("Cannot read size of file: " + fileName);
+		}
+
+		m_size = static_cast<size_t>(fileStat.st_size);
+		if (m_size == 0) {
+			close(fd);
+			return;
+		}
+
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			m_size = 0;
+			throw std::runtime_error("Cannot map file: " + fileName);
+		}
+
+		madvise(data, m_size, MADV_SEQUENTIAL);
+		m_data = static_cast<const char*>(data);
+	}
+
+	void MappedInput::unmap()
+	{
+		if (m_data != nullptr) {
+			munmap(const_cast<char*>(m_data), m_size);
+		}
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+
+
+	MappedInput::~MappedInput()
+	{
+		unmap();
+	}
+
+	MappedInput::MappedInput(MappedInput&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedInput& MappedInput::operator=(MappedInput&& other) noexcept
+	{
+		if (this != &other) {
+			unmap();
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+#ifdef _WIN32
+			std::swap(m_file, other.m_file);
+			std::swap(m_mapping, other.m_mapping);
+#endif
+		}
+		return *this;
+	}
+
+	std::vector<std::string_view> MappedInput::lines() const
+	{
+		std::vector<std::string_view> result;
+		result.reserve(std::count(m_data, m_data + m_size, '\n') + 1);
+		for (std::string_view line : *this) {
+			result.push_back(line);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+namespace aoc {
+	// Whole input file mapped read-only into memory. Lines are handed out as
+	// string_views pointing into the mapping, so they stay valid only as long
+	// as the MappedInput object itself.
+	class MappedInput
+	{
+	public:
+		// Splits lazily on '\n' and drops trailing '\r', same lines as std::getline
+		class LineIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			LineIterator() = default;
+			LineIterator(const char* begin, const char* end);
+
+			reference operator*() const { return m_line; }
+			pointer operator->() const { return &m_line; }
+
+			LineIterator& operator++();
+			LineIterator operator++(int);
+
+			bool operator==(const LineIterator& it) const { return m_begin == it.m_begin; }
+
+		private:
+			void readLine();
+
+			const char* m_begin = nullptr;
+			const char* m_next = nullptr;
+			const char* m_end = nullptr;
+			std::string_view m_line;
+		};
+
+		explicit MappedInput(const std::string& fileName);
+		~MappedInput();
+
+		MappedInput(const MappedInput&) = delete;
+		MappedInput& operator=(const MappedInput&) = delete;
+		MappedInput(MappedInput&& other) noexcept;
+		MappedInput& operator=(MappedInput&& other) noexcept;
+
+		std::string_view content() const { return { m_data, m_size }; }
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		LineIterator begin() const { return { m_data, m_data + m_size }; }
+		LineIterator end() const { return { m_data + m_size, m_data + m_size }; }
+
+		// For parsers that need random access, lines themselves are not copied
+		std::vector<std::string_view> lines() const;
+
+	private:
+		void unmap();
+
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include "FlatHash.hpp"
+
+namespace aoc {
+	// Cache of computed results shared by the threads of a parallel solve.
+	// The table is split into shards by the high bits of the hash, every shard
+	// has its own lock and an open addressing array, so threads working on
+	// different keys rarely wait on each other. A shard grows until its share
+	// of maxEntries and then evicts: an entry always lies within PROBE_LIMIT
+	// slots of its home, and an insert into a full window replaces the first
+	// entry not read since the last sweep over it (second chance).
+	//
+	// Values are computed outside the lock, so a compute function may recurse
+	// into the same table. Two threads asking for a missing key at once may both
+	// compute it, which is only a waste when the function is pure.
+	template<typename Key, typename Value, typename Hash = aoc::Hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class MemoTable
+	{
+	public:
+		static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+		static constexpr size_t PROBE_LIMIT = 16;
+
+		explicit MemoTable(size_t maxEntries, size_t shardCount = DEFAULT_SHARD_COUNT)
+			: m_shards(std::bit_ceil(std::max<size_t>(shardCount, 1))),
+			m_shardBits{ static_cast<unsigned>(std::countr_zero(m_shards.size())) }
+		{
+			size_t perShard = std::bit_ceil(std::max(maxEntries / m_shards.size(), MIN_CAPACITY));
+			for (Shard& shard : m_shards) {
+				shard.maxCapacity = perShard;
+			}
+		}
+
+		MemoTable(const MemoTable&) = delete;
+		MemoTable& operator=(const MemoTable&) = delete;
+
+		std::optional<Value> find(const Key& key) const
+		{
+			size_t hash = m_hash(key);
+			Shard& shard = shardOf(hash);
+			std::lock_guard lock(shard.mutex);
+			Slot* slot = shard.find(key, hash, m_equal);
+			if (slot == nullptr) {
+				return std::nullopt;
+			}
+			slot->state = REFERENCED;
+			return slot->value;
+		}
+
+		// Stores value, replacing the one cached for key
+		void insert(const Key& key, const Value& value)
+		{
+			size_t hash = m_hash(key);
+			Shard& shard = shardOf(hash);
+			std::lock_guard lock(shard.mutex);
+			shard.insert(key, value, hash, m_equal);
+		}
+
+		// Cached value of key, compute() stores it first when there's none
+		template<typename Compute>
+		Value getOrCompute(const Key& key, Compute&& compute)
+		{
+			if (auto cached = find(key)) {
+				return *cached;
+			}
+
+			Value value = compute();
+			insert(key, value);
+			return value;
+		}
+
+		void clear()
+		{
+			for (Shard& shard : m_shards) {
+				std::lock_guard lock(shard.mutex);
+				shard.slots.clear();
+				shard.size = 0;
+			}
+		}
+
+		size_t size() const
+		{
+			size_t result = 0;
+			for (Shard& shard : m_shards) {
+				std::lock_guard lock(shard.mutex);
+				result += shard.size;
+			}
+			return result;
+		}
+
+		size_t evictions() const
+		{
+			size_t result = 0;
+			for (Shard& shard : m_shards) {
+				std::lock_guard lock(shard.mutex);
+				result += shard.evictions;
+			}
+			return result;
+		}
+
+	private:
+		static constexpr size_t MIN_CAPACITY = 16;
+
+		enum State : uint8_t
+		{
+			EMPTY,
+			USED,
+			REFERENCED
+		};
+
+		struct Slot
+		{
+			Key key{};
+			Value value{};
+			size_t hash = 0;
+			State state = EMPTY;
+		};
+
+		// Own cache line each, so locking one doesn't slow its neighbours
+		struct alignas(64) Shard
+		{
+			std::mutex mutex;
+			std::vector<Slot> slots;
+			size_t size = 0;
+			size_t maxCapacity = 0;
+			size_t evictions = 0;
+
+			Slot* find(const Key& key, size_t hash, const KeyEqual& equal)
+			{
+				if (slots.empty()) {
+					return nullptr;
+				}
+
+				size_t mask = slots.size() - 1;
+				for (size_t i = 0; i < PROBE_LIMIT; ++i) {
+					Slot& slot = slots[(hash + i) & mask];
+					if (slot.state == EMPTY) {
+						return nullptr;
+					}
+					if (slot.hash == hash && equal(slot.key, key)) {
+						return &slot;
+					}
+				}
+				return nullptr;
+			}
+
+			void insert(const Key& key, const Value& value, size_t hash, const KeyEqual& equal)
+			{
+				if (Slot* slot = find(key, hash, equal)) {
+					slot->value = value;
+					return;
+				}
+
+				// Kept at most half full while growing is allowed
+				if (slots.empty() || ((size + 1) * 2 > slots.size() && slots.size() < maxCapacity)) {
+					grow();
+				}
+
+				while (!place(key, value, hash)) {
+					if (slots.size() < maxCapacity) {
+						grow();
+					}
+					else {
+						evict(key, value, hash);
+						return;
+					}
+				}
+			}
+
+			bool place(const Key& key, const Value& value, size_t hash)
+			{
+				size_t mask = slots.size() - 1;
+				for (size_t i = 0; i < PROBE_LIMIT; ++i) {
+					Slot& slot = slots[(hash + i) & mask];
+					if (slot.state == EMPTY) {
+						slot = { key, value, hash, USED };
+						++size;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void evict(const Key& key, const Value& value, size_t hash)
+			{
+				size_t mask = slots.size() - 1;
+				Slot* victim = &slots[hash & mask];
+				for (size_t i = 0; i < PROBE_LIMIT; ++i) {
+					Slot& slot = slots[(hash + i) & mask];
+					if (slot.state == USED) {
+						victim = &slot;
+						break;
+					}
+					slot.state = USED;
+				}
+				*victim = { key, value, hash, USED };
+				++evictions;
+			}
+
+			// Entries that find no slot in their window after growing are dropped
+			void grow()
+			{
+				std::vector<Slot> old = std::move(slots);
+				slots.assign(std::max(old.size() * 2, std::min(MIN_CAPACITY, maxCapacity)), Slot{});
+				size = 0;
+				for (Slot& slot : old) {
+					if (slot.state != EMPTY) {
+						evictions += !place(slot.key, slot.value, slot.hash);
+					}
+				}
+			}
+		};
+
+		Shard& shardOf(size_t hash) const
+		{
+			if (m_shardBits == 0) {
+				return m_shards[0];
+			}
+			return m_shards[hash >> (sizeof(size_t) * 8 - m_shardBits)];
+		}
+
+		mutable std::vector<Shard> m_shards;
+		unsigned m_shardBits;
+		Hash m_hash;
+		KeyEqual m_equal;
+	};
+}
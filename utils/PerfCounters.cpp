@@ -0,0 +1,159 @@
+#include "PerfCounters.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace aoc {
+#if defined(__linux__)
+	namespace {
+		perf_event_attr counterAttr(PerfCounters::Counter counter)
+		{
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+
+			switch (counter) {
+			case PerfCounters::CYCLES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case PerfCounters::INSTRUCTIONS:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case PerfCounters::L1D_MISSES:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D
+					| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+					| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case PerfCounters::LLC_MISSES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CACHE_MISSES;
+				break;
+			case PerfCounters::BRANCH_MISSES:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+			default:
+				break;
+			}
+			return attr;
+		}
+
+		int openCounter(perf_event_attr& attr, int groupFd)
+		{
+			// Calling thread on any CPU
+			return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+		}
+	}
+
+	PerfCounters::PerfCounters()
+	{
+		m_fds.fill(-1);
+		m_groupIdx.fill(0);
+
+		int firstErrno = 0;
+		for (int c = 0; c < COUNTER_NUM; ++c) {
+			perf_event_attr attr = counterAttr(static_cast<Counter>(c));
+			// The group starts disabled and is enabled once complete
+			attr.disabled = m_leaderFd < 0 ? 1 : 0;
+			int fd = openCounter(attr, m_leaderFd);
+			if (fd < 0) {
+				firstErrno = firstErrno == 0 ? errno : firstErrno;
+				continue;
+			}
+
+			if (m_leaderFd < 0) {
+				m_leaderFd = fd;
+			}
+			m_fds[c] = fd;
+			m_groupIdx[c] = m_groupSize++;
+		}
+
+		if (m_leaderFd < 0) {
+			m_unavailableReason = std::string("perf_event_open failed: ") + std::strerror(firstErrno);
+			if (firstErrno == EACCES || firstErrno == EPERM) {
+				m_unavailableReason += " (see /proc/sys/kernel/perf_event_paranoid)";
+			}
+			return;
+		}
+
+		ioctl(m_leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(m_leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+
+	PerfCounters::~PerfCounters()
+	{
+		for (int fd : m_fds) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+	}
+
+	PerfCounters::Values PerfCounters::read() const
+	{
+		Values values{};
+		if (m_leaderFd < 0) {
+			return values;
+		}
+
+		// nr, time enabled, time running, then one value per counter
+		uint64_t data[3 + COUNTER_NUM]{};
+		ssize_t size = ::read(m_leaderFd, data, sizeof(data));
+		if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[0] != m_groupSize) {
+			return values;
+		}
+
+		uint64_t enabled = data[1];
+		uint64_t running = data[2];
+		for (int c = 0; c < COUNTER_NUM; ++c) {
+			if (m_fds[c] < 0) {
+				continue;
+			}
+
+			uint64_t value = data[3 + m_groupIdx[c]];
+			if (running != 0 && running < enabled) {
+				value = static_cast<uint64_t>(static_cast<double>(value) * enabled / running);
+			}
+			values[c] = value;
+		}
+		return values;
+	}
+#else
+	PerfCounters::PerfCounters()
+		: m_unavailableReason{ "Hardware counters are only read on Linux" }
+	{
+		m_fds.fill(-1);
+		m_groupIdx.fill(0);
+	}
+
+	PerfCounters::~PerfCounters() = default;
+
+	PerfCounters::Values PerfCounters::read() const
+	{
+		return {};
+	}
+#endif
+
+	std::string_view PerfCounters::name(Counter counter)
+	{
+		switch (counter) {
+		case CYCLES: return "cycles";
+		case INSTRUCTIONS: return "instructions";
+		case L1D_MISSES: return "l1d_misses";
+		case LLC_MISSES: return "llc_misses";
+		case BRANCH_MISSES: return "branch_misses";
+		default: return "unknown";
+		}
+	}
+}
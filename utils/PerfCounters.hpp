@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace aoc {
+	// Hardware counters of the calling thread, read through perf_event_open on
+	// Linux. Counters the kernel or the CPU doesn't offer (no PMU in a VM,
+	// perf_event_paranoid, other systems) are simply unavailable, reading
+	// then gives zeros for them. All available counters are opened as one
+	// group, so they count over exactly the same instructions.
+	class PerfCounters
+	{
+	public:
+		enum Counter
+		{
+			CYCLES,
+			INSTRUCTIONS,
+			L1D_MISSES,
+			LLC_MISSES,
+			BRANCH_MISSES,
+			COUNTER_NUM
+		};
+
+		using Values = std::array<uint64_t, COUNTER_NUM>;
+
+		PerfCounters();
+		~PerfCounters();
+
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+
+		bool available(Counter counter) const { return m_fds[counter] >= 0; }
+		bool anyAvailable() const { return m_leaderFd >= 0; }
+		// Why nothing could be opened, empty if anything could
+		const std::string& unavailableReason() const { return m_unavailableReason; }
+
+		// Counts since the counters were opened, scaled up when the kernel had
+		// to share the hardware between more events than it has counters
+		Values read() const;
+
+		static std::string_view name(Counter counter);
+
+	private:
+		std::array<int, COUNTER_NUM> m_fds;
+		// Position of each counter in a group read, counters are in open order
+		std::array<size_t, COUNTER_NUM> m_groupIdx;
+		size_t m_groupSize = 0;
+		int m_leaderFd = -1;
+		std::string m_unavailableReason;
+	};
+}
@@ -0,0 +1,244 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace aoc {
+	Profiler& Profiler::instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	Profiler::Profiler()
+	{
+		const char* reportPath = std::getenv("AOC_PROFILE");
+		if (reportPath != nullptr && *reportPath != '\0') {
+			m_enabled = true;
+			m_reportPath = reportPath;
+		}
+
+		const char* counters = std::getenv("AOC_PROFILE_COUNTERS");
+		m_countersEnabled = counters != nullptr && *counters != '\0';
+	}
+
+	Profiler::~Profiler()
+	{
+		if (m_reportPath.empty()) {
+			return;
+		}
+
+		if (m_reportPath == "-") {
+			writeJson(std::cerr);
+			return;
+		}
+
+		std::ofstream report(m_reportPath);
+		if (!report) {
+			std::cerr << "Cannot write profile report: " << m_reportPath << std::endl;
+			return;
+		}
+		writeJson(report);
+	}
+
+	std::vector<Profiler::OpenPhase>& Profiler::openPhases()
+	{
+		thread_local std::vector<OpenPhase> phases;
+		return phases;
+	}
+
+	void Profiler::begin(std::string_view name)
+	{
+		auto& phases = openPhases();
+		std::string path;
+		if (!phases.empty()) {
+			path = phases.back().path;
+			path += '/';
+		}
+		path += name;
+
+		// Counters are read last when starting and first when ending, so the
+		// profiler's own work stays out of them as much as possible
+		const PerfCounters* counters = m_countersEnabled ? threadCounters() : nullptr;
+		phases.push_back({ std::move(path), Clock::now(), counters, {}, {}, 0 });
+		if constexpr (AllocationTracker::ENABLED) {
+			phases.back().outerPeak = AllocationTracker::restartPeak();
+			phases.back().startAllocations = AllocationTracker::current();
+		}
+		if (counters != nullptr) {
+			phases.back().startCounters = counters->read();
+		}
+	}
+
+	void Profiler::end()
+	{
+		auto& phases = openPhases();
+		if (phases.empty()) {
+			throw std::logic_error("Profiler::end without matching begin");
+		}
+
+		PerfCounters::Values endCounters{};
+		if (phases.back().counters != nullptr) {
+			endCounters = phases.back().counters->read();
+		}
+		Clock::time_point now = Clock::now();
+		AllocationCounts endAllocations = AllocationTracker::current();
+		if constexpr (AllocationTracker::ENABLED) {
+			AllocationTracker::endPeak(phases.back().outerPeak);
+		}
+
+		OpenPhase phase = std::move(phases.back());
+		phases.pop_back();
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase.start).count();
+		std::lock_guard lock(m_mutex);
+		m_samples[phase.path].push_back(static_cast<uint64_t>(ns));
+		if (phase.counters != nullptr) {
+			CounterTotals& totals = m_counterTotals[phase.path];
+			++totals.count;
+			for (size_t c = 0; c < totals.values.size(); ++c) {
+				totals.values[c] += endCounters[c] - phase.startCounters[c];
+			}
+		}
+		if constexpr (AllocationTracker::ENABLED) {
+			const AllocationCounts& start = phase.startAllocations;
+			AllocationTotals& totals = m_allocationTotals[phase.path];
+			totals.allocations += endAllocations.allocations - start.allocations;
+			totals.bytes += endAllocations.bytes - start.bytes;
+			totals.peakLiveBytes = std::max(totals.peakLiveBytes,
+				endAllocations.peakLiveBytes - std::min(endAllocations.peakLiveBytes, start.liveBytes));
+		}
+	}
+
+	const PerfCounters* Profiler::threadCounters()
+	{
+		thread_local std::unique_ptr<PerfCounters> counters;
+		if (counters == nullptr) {
+			counters = std::make_unique<PerfCounters>();
+
+			std::lock_guard lock(m_mutex);
+			for (size_t c = 0; c < m_availableCounters.size(); ++c) {
+				bool available = counters->available(static_cast<PerfCounters::Counter>(c));
+				m_availableCounters[c] = available && (m_availableCounters[c] || !m_countersOpened);
+			}
+			m_countersOpened = true;
+
+			if (!counters->anyAvailable() && !m_unavailableReported) {
+				std::cerr << "Hardware counters unavailable, timing only. "
+					<< counters->unavailableReason() << std::endl;
+				m_unavailableReported = true;
+			}
+		}
+
+		return counters->anyAvailable() ? counters.get() : nullptr;
+	}
+
+	bool Profiler::counterAvailable(PerfCounters::Counter counter) const
+	{
+		std::lock_guard lock(m_mutex);
+		return m_availableCounters[counter];
+	}
+
+	std::vector<Profiler::PhaseStats> Profiler::stats() const
+	{
+		std::lock_guard lock(m_mutex);
+		std::vector<PhaseStats> result;
+		for (const auto& [name, samples] : m_samples) {
+			std::vector<uint64_t> sorted = samples;
+			std::sort(sorted.begin(), sorted.end());
+
+			PhaseStats phase{};
+			phase.name = name;
+			phase.count = sorted.size();
+			for (uint64_t ns : sorted) {
+				phase.totalNs += ns;
+			}
+			phase.minNs = sorted.front();
+			phase.maxNs = sorted.back();
+			phase.medianNs = sorted[(sorted.size() - 1) / 2];
+			// Nearest rank, with few samples it is simply the slowest one
+			size_t p99Rank = (sorted.size() * 99 + 99) / 100;
+			phase.p99Ns = sorted[p99Rank - 1];
+
+			// Phases that also ran without counters would mix up the sums
+			auto totals = m_counterTotals.find(name);
+			phase.hasCounters = totals != m_counterTotals.end() && totals->second.count == sorted.size();
+			if (phase.hasCounters) {
+				phase.counters = totals->second.values;
+			}
+
+			auto allocations = m_allocationTotals.find(name);
+			if (allocations != m_allocationTotals.end()) {
+				phase.allocations = allocations->second.allocations;
+				phase.allocatedBytes = allocations->second.bytes;
+				phase.peakLiveBytes = allocations->second.peakLiveBytes;
+			}
+			result.push_back(std::move(phase));
+		}
+
+		return result;
+	}
+
+	void Profiler::writeJson(std::ostream& out) const
+	{
+		auto escaped = [](const std::string& s) {
+			std::string result;
+			for (char c : s) {
+				if (c == '"' || c == '\\') {
+					result += '\\';
+				}
+				result += c;
+			}
+			return result;
+		};
+
+		out << "{\n\t\"phases\": [";
+		bool first = true;
+		for (const auto& phase : stats()) {
+			out << (first ? "\n" : ",\n")
+				<< "\t\t{ \"name\": \"" << escaped(phase.name) << "\""
+				<< ", \"count\": " << phase.count
+				<< ", \"total_ns\": " << phase.totalNs
+				<< ", \"min_ns\": " << phase.minNs
+				<< ", \"median_ns\": " << phase.medianNs
+				<< ", \"p99_ns\": " << phase.p99Ns
+				<< ", \"max_ns\": " << phase.maxNs;
+			if (phase.hasCounters) {
+				out << ", \"counters\": {";
+				const char* separator = " ";
+				for (int c = 0; c < PerfCounters::COUNTER_NUM; ++c) {
+					auto counter = static_cast<PerfCounters::Counter>(c);
+					if (counterAvailable(counter)) {
+						out << separator << "\"" << PerfCounters::name(counter) << "\": " << phase.counters[c];
+						separator = ", ";
+					}
+				}
+				if (counterAvailable(PerfCounters::CYCLES) && counterAvailable(PerfCounters::INSTRUCTIONS)
+					&& phase.counters[PerfCounters::CYCLES] != 0) {
+					out << separator << "\"ipc\": "
+						<< static_cast<double>(phase.counters[PerfCounters::INSTRUCTIONS]) / phase.counters[PerfCounters::CYCLES];
+				}
+				out << " }";
+			}
+			if (AllocationTracker::ENABLED) {
+				out << ", \"allocations\": { \"count\": " << phase.allocations
+					<< ", \"bytes\": " << phase.allocatedBytes
+					<< ", \"peak_live_bytes\": " << phase.peakLiveBytes
+					<< " }";
+			}
+			out << " }";
+			first = false;
+		}
+		out << "\n\t]\n}\n";
+	}
+
+	void Profiler::reset()
+	{
+		std::lock_guard lock(m_mutex);
+		m_samples.clear();
+		m_counterTotals.clear();
+		m_allocationTotals.clear();
+	}
+}
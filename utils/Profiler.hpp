@@ -0,0 +1,148 @@
+#pragma once
+#include "PerfCounters.hpp"
+#include "AllocationTracker.hpp"
+#include "Trace.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <utility>
+#include <memory>
+#include <cstdint>
+
+namespace aoc {
+	// Collects nanosecond timings of named phases. Phases can nest, an inner
+	// phase is recorded as "outer/inner". Repeated phases are aggregated, so
+	// running the same file many times gives min/median/p99 per phase.
+	// Measuring is off unless the AOC_PROFILE environment variable is set, its
+	// value is the path the JSON report is written to at exit ("-" for stderr).
+	// With AOC_PROFILE_COUNTERS set as well, hardware counters are read at the
+	// start and end of every phase too (see PerfCounters). Builds tracking
+	// allocations record the allocations of every phase as well.
+	class Profiler
+	{
+	public:
+		struct PhaseStats
+		{
+			std::string name;
+			size_t count;
+			uint64_t totalNs;
+			uint64_t minNs;
+			uint64_t medianNs;
+			uint64_t p99Ns;
+			uint64_t maxNs;
+			// Sums over all runs, only for counters available on every run
+			bool hasCounters;
+			PerfCounters::Values counters;
+			// Sums over all runs, only in builds tracking allocations
+			uint64_t allocations;
+			uint64_t allocatedBytes;
+			// Highest over all runs, above what was live when the phase started
+			uint64_t peakLiveBytes;
+		};
+
+		static Profiler& instance();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+		~Profiler();
+
+		bool enabled() const { return m_enabled; }
+		void setEnabled(bool enabled) { m_enabled = enabled; }
+		bool countersEnabled() const { return m_countersEnabled; }
+		void setCountersEnabled(bool enabled) { m_countersEnabled = enabled; }
+		bool counterAvailable(PerfCounters::Counter counter) const;
+
+		// Every begin must be matched by an end on the same thread
+		void begin(std::string_view name);
+		void end();
+
+		std::vector<PhaseStats> stats() const;
+		void writeJson(std::ostream& out) const;
+		void reset();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct OpenPhase
+		{
+			std::string path;
+			Clock::time_point start;
+			const PerfCounters* counters;
+			PerfCounters::Values startCounters;
+			AllocationCounts startAllocations;
+			uint64_t outerPeak;
+		};
+
+		struct CounterTotals
+		{
+			size_t count = 0;
+			PerfCounters::Values values{};
+		};
+
+		struct AllocationTotals
+		{
+			uint64_t allocations = 0;
+			uint64_t bytes = 0;
+			uint64_t peakLiveBytes = 0;
+		};
+
+		Profiler();
+
+		static std::vector<OpenPhase>& openPhases();
+		// Counters of the calling thread, null while they are off or unavailable
+		const PerfCounters* threadCounters();
+
+		bool m_enabled = false;
+		bool m_countersEnabled = false;
+		std::string m_reportPath;
+		mutable std::mutex m_mutex;
+		std::map<std::string, std::vector<uint64_t>> m_samples;
+		std::map<std::string, CounterTotals> m_counterTotals;
+		std::map<std::string, AllocationTotals> m_allocationTotals;
+		// Counters every thread could open, set by the first one to open them
+		std::array<bool, PerfCounters::COUNTER_NUM> m_availableCounters{};
+		bool m_countersOpened = false;
+		bool m_unavailableReported = false;
+	};
+
+
+	// Also shows up in the trace when AOC_TRACE is set
+	class ScopedPhase
+	{
+	public:
+		explicit ScopedPhase(std::string_view name)
+			: m_active{ Profiler::instance().enabled() }, m_trace{ name, "phase" }
+		{
+			if (m_active) {
+				Profiler::instance().begin(name);
+			}
+		}
+
+		~ScopedPhase()
+		{
+			if (m_active) {
+				Profiler::instance().end();
+			}
+		}
+
+		ScopedPhase(const ScopedPhase&) = delete;
+		ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+	private:
+		bool m_active;
+		TraceSpan m_trace;
+	};
+
+
+	// Runs fn as a phase and passes its result on, so it fits into an output chain
+	template<typename Fn>
+	decltype(auto) profile(std::string_view name, Fn&& fn)
+	{
+		ScopedPhase phase(name);
+		return std::forward<Fn>(fn)();
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <string_view>
+#include <stdexcept>
+#include <concepts>
+#include <limits>
+#include <charconv>
+#include <bit>
+#include <cstring>
+#include <cstdint>
+
+namespace aoc {
+	// Reads tokens from the front of a string_view without copying it.
+	// Numbers are parsed by whole digit runs, eight characters at a time,
+	// instead of char by char like std::istream does.
+	class Scanner
+	{
+	public:
+		constexpr Scanner() = default;
+		constexpr explicit Scanner(std::string_view text)
+			: m_text{ text }
+		{}
+
+		bool atEnd() const { return m_pos >= m_text.size(); }
+		size_t position() const { return m_pos; }
+		std::string_view rest() const { return m_text.substr(m_pos); }
+
+		// '\0' at the end of text
+		char peek() const { return atEnd() ? '\0' : m_text[m_pos]; }
+
+		// Consumes c if it's the next char
+		bool skip(char c)
+		{
+			if (peek() != c || atEnd()) {
+				return false;
+			}
+			++m_pos;
+			return true;
+		}
+
+		// Consumes prefix if the rest starts with it
+		bool skip(std::string_view prefix)
+		{
+			if (!rest().starts_with(prefix)) {
+				return false;
+			}
+			m_pos += prefix.size();
+			return true;
+		}
+
+		void expect(char c)
+		{
+			if (!skip(c)) {
+				throw std::invalid_argument(std::string("Expected '") + c + "' at position " + std::to_string(m_pos));
+			}
+		}
+
+		void expect(std::string_view prefix)
+		{
+			if (!skip(prefix)) {
+				throw std::invalid_argument("Expected \"" + std::string(prefix) + "\" at position " + std::to_string(m_pos));
+			}
+		}
+
+		void skipWhitespace()
+		{
+			while (!atEnd() && isWhitespace(m_text[m_pos])) {
+				++m_pos;
+			}
+		}
+
+		// Moves to the start of the next number, a '-' counts only right before a digit
+		template<std::integral T>
+		void skipToNumber()
+		{
+			while (!atEnd()) {
+				char c = m_text[m_pos];
+				if (isDigit(c)) {
+					return;
+				}
+				if constexpr (std::is_signed_v<T>) {
+					if (c == '-' && m_pos + 1 < m_text.size() && isDigit(m_text[m_pos + 1])) {
+						return;
+					}
+				}
+				++m_pos;
+			}
+		}
+
+		// Skips whitespace and reads a number, a leading '-' only for signed types.
+		// Returns false and consumes nothing if there's no number in range.
+		template<std::integral T>
+		bool tryNextInt(T& value)
+		{
+			skipWhitespace();
+			size_t start = m_pos;
+			bool negative = false;
+			if constexpr (std::is_signed_v<T>) {
+				negative = skip('-');
+			}
+
+			const char* first = m_text.data() + m_pos;
+			const char* last = m_text.data() + m_text.size();
+			size_t digits = digitRunLength(first, last);
+			if (digits == 0) {
+				m_pos = start;
+				return false;
+			}
+
+			if (digits > MAX_FAST_DIGITS) {
+				// Leading zeros or out of range, let the standard library decide
+				auto [ptr, ec] = std::from_chars(m_text.data() + start, first + digits, value);
+				if (ec != std::errc{} || ptr != first + digits) {
+					m_pos = start;
+					return false;
+				}
+				m_pos += digits;
+				return true;
+			}
+
+			uint64_t magnitude = parseDigits(first, digits);
+			using U = std::make_unsigned_t<T>;
+			uint64_t limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+			if (magnitude > limit) {
+				m_pos = start;
+				return false;
+			}
+
+			value = negative
+				? static_cast<T>(U{} - static_cast<U>(magnitude))
+				: static_cast<T>(magnitude);
+			m_pos += digits;
+			return true;
+		}
+
+		template<std::integral T>
+		T nextInt()
+		{
+			T value;
+			if (!tryNextInt(value)) {
+				throw std::invalid_argument("Expected number at position " + std::to_string(m_pos));
+			}
+			return value;
+		}
+
+		// Number of leading chars in [first, last) that are decimal digits
+		static size_t digitRunLength(const char* first, const char* last)
+		{
+			const char* it = first;
+			if constexpr (std::endian::native == std::endian::little) {
+				while (last - it >= 8) {
+					uint64_t word;
+					std::memcpy(&word, it, sizeof(word));
+					uint64_t nonDigits = nonDigitMask(word);
+					if (nonDigits != 0) {
+						return (it - first) + std::countr_zero(nonDigits) / 8;
+					}
+					it += 8;
+				}
+			}
+
+			while (it != last && isDigit(*it)) {
+				++it;
+			}
+			return it - first;
+		}
+
+	private:
+		// 19 digits always fit in uint64_t
+		static constexpr size_t MAX_FAST_DIGITS = 19;
+		static constexpr uint64_t ONES = 0x0101010101010101ULL;
+		static constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+		static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+		static constexpr bool isWhitespace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+		// High bit of every byte of word that is not '0'..'9'. Setting the high bit
+		// before subtracting keeps borrows from crossing into the next byte.
+		static constexpr uint64_t nonDigitMask(uint64_t word)
+		{
+			uint64_t atLeastZero = (word | HIGH_BITS) - ONES * '0';
+			uint64_t aboveNine = (word | HIGH_BITS) - ONES * ('9' + 1);
+			uint64_t digits = atLeastZero & ~aboveNine & ~word & HIGH_BITS;
+			return ~digits & HIGH_BITS;
+		}
+
+		// Eight ASCII digits, first char in the lowest byte, to their value
+		static constexpr uint64_t parseEightDigits(uint64_t word)
+		{
+			word -= ONES * '0';
+			word = (word * 10) + (word >> 8);
+			word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+				+ (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+			return word & 0xFFFFFFFFULL;
+		}
+
+		// count must be at most MAX_FAST_DIGITS, all chars are digits
+		static uint64_t parseDigits(const char* first, size_t count)
+		{
+			uint64_t result = 0;
+			if constexpr (std::endian::native == std::endian::little) {
+				while (count >= 8) {
+					uint64_t word;
+					std::memcpy(&word, first, sizeof(word));
+					result = result * 100000000ULL + parseEightDigits(word);
+					first += 8;
+					count -= 8;
+				}
+			}
+
+			for (; count > 0; --count) {
+				result = result * 10 + static_cast<uint64_t>(*first++ - '0');
+			}
+			return result;
+		}
+
+		std::string_view m_text;
+		size_t m_pos = 0;
+	};
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace aoc {
+	// One day's puzzle split into steps that can be timed separately.
+	// parse can be called again to start over with new input. Parts must
+	// leave the parsed input unchanged, so they can be run any number of
+	// times in any order. A day without a second part returns an empty string.
+	class Solver
+	{
+	public:
+		virtual ~Solver() = default;
+
+		virtual void parse(const std::vector<std::string>& files) = 0;
+		virtual std::string part1() = 0;
+		virtual std::string part2() = 0;
+	};
+}
@@ -0,0 +1,111 @@
+#include "StreamReader.hpp"
+#include <stdexcept>
+#include <cstring>
+
+namespace aoc {
+	StreamReader::StreamReader(const std::string& fileName, size_t chunkSize)
+		: m_file{ fileName, std::ios::binary }, m_fileName{ fileName },
+		m_buffer{ std::make_unique<char[]>(2 * chunkSize) }, m_capacity{ 2 * chunkSize }
+	{
+		if (!m_file.is_open()) {
+			throw std::runtime_error("Cannot open file: " + fileName);
+		}
+	}
+
+	bool StreamReader::nextLine(std::string_view& line)
+	{
+		size_t lineEnd = 0;
+		bool newline = findLineEnd(0, lineEnd);
+		if (!newline && lineEnd == 0) {
+			return false;
+		}
+
+		line = view(0, lineEnd);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		m_begin += lineEnd + (newline ? 1 : 0);
+		return true;
+	}
+
+	bool StreamReader::nextRecord(std::string_view& record)
+	{
+		size_t lineEnd = 0;
+		bool newline = findLineEnd(0, lineEnd);
+		while (newline && isEmptyLine(0, lineEnd)) {
+			m_begin += lineEnd + 1;
+			newline = findLineEnd(0, lineEnd);
+		}
+		if (!newline && isEmptyLine(0, lineEnd)) {
+			m_begin = m_end;
+			return false;
+		}
+
+		// Lines stay unconsumed until the record ends, so a refill keeps all of it
+		size_t recordEnd = lineEnd;
+		size_t consumed = lineEnd + (newline ? 1 : 0);
+		while (newline) {
+			newline = findLineEnd(consumed, lineEnd);
+			bool emptyLine = isEmptyLine(consumed, lineEnd);
+			consumed = lineEnd + (newline ? 1 : 0);
+			if (emptyLine) {
+				break;
+			}
+			recordEnd = lineEnd;
+		}
+
+		record = view(0, recordEnd);
+		if (!record.empty() && record.back() == '\r') {
+			record.remove_suffix(1);
+		}
+		m_begin += consumed;
+		return true;
+	}
+
+	bool StreamReader::findLineEnd(size_t offset, size_t& lineEnd)
+	{
+		while (true) {
+			const char* from = m_buffer.get() + m_begin + offset;
+			const void* found = std::memchr(from, '\n', m_end - (m_begin + offset));
+			if (found != nullptr) {
+				lineEnd = static_cast<const char*>(found) - (m_buffer.get() + m_begin);
+				return true;
+			}
+
+			if (m_eof) {
+				lineEnd = m_end - m_begin;
+				return false;
+			}
+			refill();
+		}
+	}
+
+	bool StreamReader::isEmptyLine(size_t offset, size_t lineEnd) const
+	{
+		return lineEnd == offset || (lineEnd == offset + 1 && m_buffer[m_begin + offset] == '\r');
+	}
+
+	void StreamReader::refill()
+	{
+		size_t kept = m_end - m_begin;
+		if (kept == m_capacity) {
+			throw std::length_error("Record longer than the read buffer in file: " + m_fileName);
+		}
+
+		std::memmove(m_buffer.get(), m_buffer.get() + m_begin, kept);
+		m_begin = 0;
+		m_end = kept;
+
+		m_file.read(m_buffer.get() + m_end, m_capacity - m_end);
+		size_t readCount = static_cast<size_t>(m_file.gcount());
+		m_end += readCount;
+		if (!m_file) {
+			m_eof = true;
+		}
+	}
+
+	std::string_view StreamReader::view(size_t offset, size_t length) const
+	{
+		return { m_buffer.get() + m_begin + offset, length };
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <memory>
+#include <cstddef>
+
+namespace aoc {
+	// Reads a file front to back through a fixed buffer of two chunks, so memory
+	// doesn't grow with the file. Whatever is left of a line or record cut by
+	// the end of a chunk moves to the front and the next chunk is read behind
+	// it. Handed out views are valid until the next read, a line or record
+	// must fit in the buffer.
+	class StreamReader
+	{
+	public:
+		static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		explicit StreamReader(const std::string& fileName, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+		// Same lines as MappedInput, without '\n' and trailing '\r'
+		bool nextLine(std::string_view& line);
+
+		// Group of non-empty lines ended by an empty line or the end of file,
+		// without the last newline. Extra empty lines between records are skipped.
+		bool nextRecord(std::string_view& record);
+
+		template<typename OnLine>
+		void forEachLine(OnLine&& onLine)
+		{
+			std::string_view line;
+			while (nextLine(line)) {
+				onLine(line);
+			}
+		}
+
+		template<typename OnRecord>
+		void forEachRecord(OnRecord&& onRecord)
+		{
+			std::string_view record;
+			while (nextRecord(record)) {
+				onRecord(record);
+			}
+		}
+
+	private:
+		// Finds the first '\n' at offset or later, offsets count from the first
+		// unconsumed char. Reads more while there's none, false at end of file
+		// with lineEnd at the end of the data.
+		bool findLineEnd(size_t offset, size_t& lineEnd);
+		bool isEmptyLine(size_t offset, size_t lineEnd) const;
+		void refill();
+		std::string_view view(size_t offset, size_t length) const;
+
+		std::ifstream m_file;
+		std::string m_fileName;
+		std::unique_ptr<char[]> m_buffer;
+		size_t m_capacity;
+		size_t m_begin = 0;
+		size_t m_end = 0;
+		bool m_eof = false;
+	};
+}
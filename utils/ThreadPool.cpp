@@ -0,0 +1,230 @@
+#include "ThreadPool.hpp"
+#include <stdexcept>
+#include <cstdlib>
+#include <charconv>
+#include <string_view>
+
+namespace aoc {
+	namespace {
+		// Queue of the pool the current thread works for, if any
+		thread_local const ThreadPool* t_workerPool = nullptr;
+		thread_local size_t t_workerIndex = 0;
+
+		size_t g_globalThreadCount = 0;
+
+		// More threads than this only oversubscribe the machine
+		constexpr size_t MAX_THREADS_PER_CORE = 8;
+
+		size_t hardwareThreadCount()
+		{
+			return std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		// Whole unsigned decimal in [1, MAX_THREADS_PER_CORE * cores], 0 when it isn't one
+		size_t parseThreadCount(std::string_view value)
+		{
+			size_t count = 0;
+			auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+			if (ec != std::errc{} || ptr != value.data() + value.size()
+				|| count > MAX_THREADS_PER_CORE * hardwareThreadCount()) {
+				return 0;
+			}
+			return count;
+		}
+
+		size_t defaultThreadCount()
+		{
+			if (g_globalThreadCount > 0) {
+				return g_globalThreadCount;
+			}
+
+			const char* envThreads = std::getenv("AOC_THREADS");
+			if (envThreads != nullptr) {
+				size_t count = parseThreadCount(envThreads);
+				if (count > 0) {
+					return count;
+				}
+			}
+
+			return hardwareThreadCount();
+		}
+	}
+
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		size_t workerCount = threadCount > 1 ? threadCount - 1 : 0;
+		for (size_t i = 0; i <= workerCount; ++i) {
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		for (size_t i = 0; i < workerCount; ++i) {
+			m_workers.emplace_back([this, i] { workerLoop(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_sleepMutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+
+		for (auto& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	ThreadPool& ThreadPool::global()
+	{
+		static ThreadPool pool(defaultThreadCount());
+		return pool;
+	}
+
+	void ThreadPool::setGlobalThreadCount(size_t threadCount)
+	{
+		g_globalThreadCount = threadCount;
+	}
+
+	void ThreadPool::submit(Task task, Group group)
+	{
+		if (m_workers.empty()) {
+			task();
+			return;
+		}
+
+		// Counted before it's visible, so a worker never sees the count lower than the queues
+		{
+			std::lock_guard lock(m_sleepMutex);
+			m_queuedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		WorkQueue& queue = *m_queues[currentQueueIndex()];
+		{
+			std::lock_guard lock(queue.mutex);
+			queue.tasks.push_back({ std::move(task), group });
+		}
+		m_wake.notify_one();
+	}
+
+	void ThreadPool::waitFor(const std::atomic<size_t>& pending)
+	{
+		size_t queueIndex = currentQueueIndex();
+		while (pending.load(std::memory_order_acquire) > 0) {
+			if (!tryRunOne(queueIndex, &pending)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void ThreadPool::workerLoop(size_t index)
+	{
+		t_workerPool = this;
+		t_workerIndex = index;
+		if (Tracer::instance().enabled()) {
+			Tracer::instance().setThreadName("worker " + std::to_string(index));
+		}
+
+		while (true) {
+			if (tryRunOne(index, nullptr)) {
+				continue;
+			}
+
+			std::unique_lock lock(m_sleepMutex);
+			m_wake.wait(lock, [this] { return m_stop || m_queuedCount.load(std::memory_order_relaxed) > 0; });
+			if (m_stop && m_queuedCount.load(std::memory_order_relaxed) == 0) {
+				return;
+			}
+		}
+	}
+
+	bool ThreadPool::tryRunOne(size_t queueIndex, Group group)
+	{
+		Task task;
+		if (!popOwn(queueIndex, group, task) && !steal(queueIndex, group, task)) {
+			return false;
+		}
+
+		m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+		task();
+		return true;
+	}
+
+	// Newest task of the group, a waiter's own tasks are usually at the back
+	bool ThreadPool::popOwn(size_t queueIndex, Group group, Task& task)
+	{
+		WorkQueue& queue = *m_queues[queueIndex];
+		std::lock_guard lock(queue.mutex);
+		auto it = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(),
+			[group](const QueuedTask& queued) { return group == nullptr || queued.group == group; });
+		if (it == queue.tasks.rend()) {
+			return false;
+		}
+
+		task = std::move(it->task);
+		queue.tasks.erase(std::next(it).base());
+		return true;
+	}
+
+	// Oldest task of the group from the first other queue that has one
+	bool ThreadPool::steal(size_t thiefIndex, Group group, Task& task)
+	{
+		for (size_t i = 1; i < m_queues.size(); ++i) {
+			WorkQueue& queue = *m_queues[(thiefIndex + i) % m_queues.size()];
+			std::lock_guard lock(queue.mutex);
+			auto it = std::find_if(queue.tasks.begin(), queue.tasks.end(),
+				[group](const QueuedTask& queued) { return group == nullptr || queued.group == group; });
+			if (it != queue.tasks.end()) {
+				task = std::move(it->task);
+				queue.tasks.erase(it);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	size_t ThreadPool::currentQueueIndex() const
+	{
+		return t_workerPool == this ? t_workerIndex : m_queues.size() - 1;
+	}
+
+	size_t ThreadPool::autoGrain(size_t count) const
+	{
+		static constexpr size_t CHUNKS_PER_THREAD = 8;
+		return std::max<size_t>(1, count / (threadCount() * CHUNKS_PER_THREAD));
+	}
+
+
+	void consumeThreadsOption(std::vector<std::string>& args)
+	{
+		static const std::string option = "--threads";
+		for (size_t i = 0; i < args.size(); ++i) {
+			std::string value;
+			size_t consumed = 0;
+			if (args[i] == option) {
+				if (i + 1 >= args.size()) {
+					throw std::invalid_argument("Missing value for " + option);
+				}
+				value = args[i + 1];
+				consumed = 2;
+			}
+			else if (args[i].starts_with(option + "=")) {
+				value = args[i].substr(option.size() + 1);
+				consumed = 1;
+			}
+			else {
+				continue;
+			}
+
+			size_t threadCount = parseThreadCount(value);
+			if (threadCount == 0) {
+				throw std::invalid_argument("Invalid value for " + option + ": " + value);
+			}
+
+			ThreadPool::setGlobalThreadCount(threadCount);
+			args.erase(args.begin() + i, args.begin() + i + consumed);
+			--i;
+		}
+	}
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include "Trace.hpp"
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <optional>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+namespace aoc {
+	// Fixed set of workers, each with its own deque of tasks. A worker takes
+	// the newest task of its own deque and when that runs dry steals the oldest
+	// one of another worker, which for split ranges is the biggest piece left.
+	// A thread waiting for its tasks runs queued work instead of blocking, but
+	// only tasks of the group it waits for: anything else, like another batch
+	// job, would run inside the waiting task's profiler phases and scopes.
+	// With tracing on, every parallelFor piece and parallelReduce chunk is an
+	// event on the thread that ran it, with the index range it covered.
+	class ThreadPool
+	{
+	public:
+		using Task = std::function<void()>;
+		// Tasks are grouped by the pending counter their waiter watches
+		using Group = const std::atomic<size_t>*;
+
+		// threadCount counts the calling thread too, 1 runs everything inline
+		explicit ThreadPool(size_t threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Shared pool sized by setGlobalThreadCount, AOC_THREADS or the hardware
+		static ThreadPool& global();
+		// Has effect only before the first call to global()
+		static void setGlobalThreadCount(size_t threadCount);
+
+		size_t threadCount() const { return m_workers.size() + 1; }
+
+		// A task without a group is only ever run by workers looking for any work
+		void submit(Task task, Group group = nullptr);
+
+		// Runs queued tasks of the pending group until it drops to zero
+		void waitFor(const std::atomic<size_t>& pending);
+
+		// Calls body(chunkBegin, chunkEnd) on chunks of at most grain indices,
+		// grain 0 picks one that gives every thread a few chunks
+		template<typename Body>
+		void parallelFor(size_t begin, size_t end, size_t grain, Body&& body);
+
+		// Reduces chunk results in index order, so combine doesn't need to be commutative
+		template<typename T, typename ChunkFn, typename Combine>
+		T parallelReduce(size_t begin, size_t end, size_t grain, T init, ChunkFn&& chunkFn, Combine&& combine);
+
+	private:
+		struct QueuedTask
+		{
+			Task task;
+			Group group;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<QueuedTask> tasks;
+		};
+
+		void workerLoop(size_t index);
+		// A null group takes any task
+		bool tryRunOne(size_t queueIndex, Group group);
+		bool popOwn(size_t queueIndex, Group group, Task& task);
+		bool steal(size_t thiefIndex, Group group, Task& task);
+		size_t currentQueueIndex() const;
+		size_t autoGrain(size_t count) const;
+
+		template<typename Body>
+		void runParallel(size_t begin, size_t end, size_t grain, Body&& body);
+
+		template<typename Body>
+		void splitRange(const Body& body, size_t begin, size_t end, size_t grain,
+			std::atomic<size_t>& pending, std::exception_ptr& error, std::mutex& errorMutex);
+
+		// The last queue is shared by threads from outside the pool
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wake;
+		std::atomic<size_t> m_queuedCount{};
+		bool m_stop = false;
+	};
+
+
+	// Removes "--threads N" or "--threads=N" from args and sizes the global pool with it.
+	// Counts must be positive and at most a few per hardware thread.
+	void consumeThreadsOption(std::vector<std::string>& args);
+
+	template<typename Body>
+	void parallelFor(size_t begin, size_t end, size_t grain, Body&& body)
+	{
+		ThreadPool::global().parallelFor(begin, end, grain, std::forward<Body>(body));
+	}
+
+	template<typename T, typename ChunkFn, typename Combine>
+	T parallelReduce(size_t begin, size_t end, size_t grain, T init, ChunkFn&& chunkFn, Combine&& combine)
+	{
+		return ThreadPool::global().parallelReduce(begin, end, grain, std::move(init),
+			std::forward<ChunkFn>(chunkFn), std::forward<Combine>(combine));
+	}
+
+
+	template<typename Body>
+	void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, Body&& body)
+	{
+		runParallel(begin, end, grain, [&body](size_t pieceBegin, size_t pieceEnd) {
+			TraceSpan span("parallelFor", "task", pieceBegin, pieceEnd);
+			body(pieceBegin, pieceEnd);
+		});
+	}
+
+	template<typename Body>
+	void ThreadPool::runParallel(size_t begin, size_t end, size_t grain, Body&& body)
+	{
+		if (begin >= end) {
+			return;
+		}
+
+		if (grain == 0) {
+			grain = autoGrain(end - begin);
+		}
+
+		if (threadCount() == 1 || end - begin <= grain) {
+			body(begin, end);
+			return;
+		}
+
+		std::atomic<size_t> pending{ 1 };
+		std::exception_ptr error;
+		std::mutex errorMutex;
+		splitRange(body, begin, end, grain, pending, error, errorMutex);
+		waitFor(pending);
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	// Keeps halving the range, queues the upper half for thieves and goes on
+	// with the lower one until it's small enough to run
+	template<typename Body>
+	void ThreadPool::splitRange(const Body& body, size_t begin, size_t end, size_t grain,
+		std::atomic<size_t>& pending, std::exception_ptr& error, std::mutex& errorMutex)
+	{
+		while (end - begin > grain) {
+			size_t mid = begin + (end - begin) / 2;
+			pending.fetch_add(1, std::memory_order_relaxed);
+			submit([this, &body, mid, end, grain, &pending, &error, &errorMutex] {
+				splitRange(body, mid, end, grain, pending, error, errorMutex);
+			}, &pending);
+			end = mid;
+		}
+
+		try {
+			body(begin, end);
+		}
+		catch (...) {
+			std::lock_guard lock(errorMutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+		}
+		pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	template<typename T, typename ChunkFn, typename Combine>
+	T ThreadPool::parallelReduce(size_t begin, size_t end, size_t grain, T init, ChunkFn&& chunkFn, Combine&& combine)
+	{
+		if (begin >= end) {
+			return init;
+		}
+
+		if (grain == 0) {
+			grain = autoGrain(end - begin);
+		}
+
+		size_t chunkCount = (end - begin + grain - 1) / grain;
+		std::vector<std::optional<T>> partials(chunkCount);
+		runParallel(0, chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+			for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+				size_t chunkBegin = begin + chunk * grain;
+				size_t chunkEnd = std::min(chunkBegin + grain, end);
+				TraceSpan span("parallelReduce", "task", chunkBegin, chunkEnd);
+				partials[chunk].emplace(chunkFn(chunkBegin, chunkEnd));
+			}
+		});
+
+		T result = std::move(init);
+		for (auto& partial : partials) {
+			result = combine(std::move(result), std::move(*partial));
+		}
+		return result;
+	}
+}
@@ -0,0 +1,117 @@
+#include "Trace.hpp"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+
+namespace aoc {
+	Tracer& Tracer::instance()
+	{
+		static Tracer tracer;
+		return tracer;
+	}
+
+	Tracer::Tracer()
+		: m_start{ std::chrono::steady_clock::now() }
+	{
+		const char* tracePath = std::getenv("AOC_TRACE");
+		if (tracePath != nullptr && *tracePath != '\0') {
+			m_enabled = true;
+			m_tracePath = tracePath;
+		}
+	}
+
+	Tracer::~Tracer()
+	{
+		if (m_tracePath.empty()) {
+			return;
+		}
+
+		std::ofstream trace(m_tracePath);
+		if (!trace) {
+			std::cerr << "Cannot write trace: " << m_tracePath << std::endl;
+			return;
+		}
+		writeJson(trace);
+	}
+
+	uint64_t Tracer::nowNs() const
+	{
+		auto elapsed = std::chrono::steady_clock::now() - m_start;
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+	void Tracer::record(Event event)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		std::lock_guard lock(buffer.mutex);
+		buffer.events.push_back(std::move(event));
+	}
+
+	void Tracer::setThreadName(std::string name)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		std::lock_guard lock(buffer.mutex);
+		buffer.name = std::move(name);
+	}
+
+	Tracer::ThreadBuffer& Tracer::threadBuffer()
+	{
+		thread_local std::shared_ptr<ThreadBuffer> buffer;
+		if (buffer == nullptr) {
+			buffer = std::make_shared<ThreadBuffer>();
+			std::lock_guard lock(m_mutex);
+			buffer->tid = m_buffers.size() + 1;
+			buffer->name = "thread " + std::to_string(buffer->tid);
+			m_buffers.push_back(buffer);
+		}
+		return *buffer;
+	}
+
+	void Tracer::writeJson(std::ostream& out) const
+	{
+		auto escaped = [](const std::string& s) {
+			std::string result;
+			for (char c : s) {
+				if (c == '"' || c == '\\') {
+					result += '\\';
+				}
+				result += c;
+			}
+			return result;
+		};
+
+		// Trace timestamps are microseconds, fractions keep the nanoseconds
+		auto micros = [](uint64_t ns) {
+			std::stringstream ss;
+			ss << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+			return ss.str();
+		};
+
+		std::lock_guard lock(m_mutex);
+		out << "{\n\t\"displayTimeUnit\": \"ns\",\n\t\"traceEvents\": [";
+		bool first = true;
+		for (const auto& buffer : m_buffers) {
+			std::lock_guard bufferLock(buffer->mutex);
+			out << (first ? "\n" : ",\n")
+				<< "\t\t{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+				<< ", \"args\": { \"name\": \"" << escaped(buffer->name) << "\" } }";
+			first = false;
+
+			for (const Event& event : buffer->events) {
+				out << ",\n\t\t{ \"name\": \"" << escaped(event.name) << "\""
+					<< ", \"cat\": \"" << event.category << "\""
+					<< ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+					<< ", \"ts\": " << micros(event.startNs)
+					<< ", \"dur\": " << micros(event.durationNs);
+				if (event.rangeBegin != event.rangeEnd) {
+					out << ", \"args\": { \"begin\": " << event.rangeBegin
+						<< ", \"end\": " << event.rangeEnd << " }";
+				}
+				out << " }";
+			}
+		}
+		out << "\n\t]\n}\n";
+	}
+}
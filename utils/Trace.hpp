@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+namespace aoc {
+	// Timeline of profiler phases and thread pool tasks in the Chrome trace
+	// event format, for chrome://tracing or ui.perfetto.dev. Recording is off
+	// unless the AOC_TRACE environment variable is set, its value is the path
+	// the trace is written to at exit. Every thread records into its own
+	// buffer, so tasks don't contend on recording.
+	class Tracer
+	{
+	public:
+		struct Event
+		{
+			std::string name;
+			const char* category;
+			uint64_t startNs;
+			uint64_t durationNs;
+			// Index range the event covered, begin == end when there's none
+			uint64_t rangeBegin;
+			uint64_t rangeEnd;
+		};
+
+		static Tracer& instance();
+
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+		~Tracer();
+
+		bool enabled() const { return m_enabled; }
+		void setEnabled(bool enabled) { m_enabled = enabled; }
+
+		uint64_t nowNs() const;
+		void record(Event event);
+		// Shown instead of the thread number in the viewer
+		void setThreadName(std::string name);
+
+		void writeJson(std::ostream& out) const;
+
+	private:
+		struct ThreadBuffer
+		{
+			size_t tid;
+			std::string name;
+			mutable std::mutex mutex;
+			std::vector<Event> events;
+		};
+
+		Tracer();
+
+		ThreadBuffer& threadBuffer();
+
+		bool m_enabled = false;
+		std::string m_tracePath;
+		std::chrono::steady_clock::time_point m_start;
+		mutable std::mutex m_mutex;
+		// Outlive their threads, pool workers may end before the trace is written
+		std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+	};
+
+
+	// Records the time from construction to destruction as one event
+	class TraceSpan
+	{
+	public:
+		TraceSpan(std::string_view name, const char* category)
+			: TraceSpan(name, category, 0, 0)
+		{}
+
+		TraceSpan(std::string_view name, const char* category, uint64_t rangeBegin, uint64_t rangeEnd)
+			: m_active{ Tracer::instance().enabled() }
+		{
+			if (m_active) {
+				m_event = { std::string(name), category, Tracer::instance().nowNs(), 0, rangeBegin, rangeEnd };
+			}
+		}
+
+		~TraceSpan()
+		{
+			if (m_active) {
+				m_event.durationNs = Tracer::instance().nowNs() - m_event.startNs;
+				Tracer::instance().record(std::move(m_event));
+			}
+		}
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	private:
+		bool m_active;
+		Tracer::Event m_event;
+	};
+}
@@ -1,5 +1,6 @@
 #include "utils.hpp"
 #include <fstream>
+#include <algorithm>
 namespace aoc{
 	std::vector<std::string> argsToString(int argc, char* args[])
 	{
@@ -9,6 +10,45 @@ namespace aoc{
 		}
 		return parsedArgs;
 	}
+
+	bool consumeFlag(std::vector<std::string>& args, std::string_view flag)
+	{
+		auto removed = std::remove(args.begin(), args.end(), flag);
+		bool found = removed != args.end();
+		args.erase(removed, args.end());
+		return found;
+	}
+
+
+	int consumeIntOption(std::vector<std::string>& args, std::string_view option, int defaultValue)
+	{
+		const std::string prefix = std::string(option) + "=";
+		int result = defaultValue;
+		for (size_t i = 0; i < args.size();) {
+			std::string value;
+			if (args[i] == option) {
+				if (i + 1 >= args.size()) {
+					throw std::invalid_argument("Missing value for " + std::string(option));
+				}
+				value = args[i + 1];
+				args.erase(args.begin() + i, args.begin() + i + 2);
+			}
+			else if (args[i].starts_with(prefix)) {
+				value = args[i].substr(prefix.size());
+				args.erase(args.begin() + i);
+			}
+			else {
+				++i;
+				continue;
+			}
+
+			Scanner scanner{ value };
+			if (!scanner.tryNextInt(result) || !scanner.atEnd()) {
+				throw std::invalid_argument("Invalid value for " + std::string(option) + ": " + value);
+			}
+		}
+		return result;
+	}
 	
 
 	std::vector<std::string> loadFile(const std::string& fileName)
@@ -25,6 +65,12 @@ namespace aoc{
 
 		return lines;
 	}
+
+	std::vector<std::string_view> splitLines(std::string_view text)
+	{
+		MappedInput::LineIterator it(text.data(), text.data() + text.size());
+		return { it, MappedInput::LineIterator(text.data() + text.size(), text.data() + text.size()) };
+	}
 	
 	uint8_t countDigits(uint64_t num) {
 		if (num == 0) {
@@ -1,13 +1,23 @@
+#pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_set>
-#include <chrono>
 #include <iostream>
 #include <array>
+#include "MappedInput.hpp"
+#include "Profiler.hpp"
+#include "Scanner.hpp"
 
 namespace aoc {
 	std::vector<std::string> argsToString(int argc, char* args[]);
+	// Removes every occurrence of flag from args, true if there was any
+	bool consumeFlag(std::vector<std::string>& args, std::string_view flag);
+	// Removes "option N" and "option=N" from args, the last value given wins
+	int consumeIntOption(std::vector<std::string>& args, std::string_view option, int defaultValue);
 	std::vector<std::string> loadFile(const std::string& fileName);
+	// Lines of text the way MappedInput splits them, views into text
+	std::vector<std::string_view> splitLines(std::string_view text);
 	uint8_t countDigits(uint64_t num);
 
 	template<typename T>
@@ -29,6 +39,22 @@ namespace aoc {
 		}
 	}
 
+	// splitmix64 finalizer, spreads every input bit over the whole result
+	constexpr uint64_t mixHash(uint64_t x)
+	{
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ULL;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebULL;
+		x ^= x >> 31;
+		return x;
+	}
+
+	constexpr uint64_t combineHash(uint64_t seed, uint64_t value)
+	{
+		return mixHash(seed + 0x9e3779b97f4a7c15ULL + value);
+	}
+
 	struct Vec2D
 	{
 		int64_t x;
@@ -60,30 +86,6 @@ namespace aoc {
 		constexpr Position operator+(const Vec2D& v) const { return { x + v.x, y + v.y }; }
 		constexpr Position operator+=(const Vec2D& v) { return *this = *this + v; }
 	};
-
-	class SimpleClock {
-	private:
-		std::chrono::high_resolution_clock::time_point startTime;
-		std::chrono::high_resolution_clock::time_point endTime;
-		bool isRunning = false;
-
-	public:
-		void start() {
-			if(isRunning) {
-				return;
-			}
-			startTime = std::chrono::high_resolution_clock::now();
-			isRunning = true;
-		}
-
-		void end() {
-			endTime = std::chrono::high_resolution_clock::now();
-			isRunning = false;
-
-			auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-			std::cout << "Execution time: " << duration << " ms" << std::endl;
-		}
-	};
 }
 
 
@@ -92,6 +94,6 @@ struct std::hash<aoc::Position>
 {
 	std::size_t operator() (const aoc::Position& p) const 
 	{
-		return std::hash<int64_t>()(p.x) ^ hash<int64_t>()(p.y) << 1;
+		return aoc::combineHash(aoc::mixHash(p.x), p.y);
 	}
 };